@@ -0,0 +1,25 @@
+#include <iostream>
+
+#include <libs/util.hpp>
+
+// Driver for the solutions registered by every dayN.cpp (built with -DAOC_DRIVER).
+// Example: `./aoc.exe day1 day6` runs only those days, no arguments runs everything.
+//          `./aoc.exe --bench=bench.csv day6` benchmarks every variant of day6 instead.
+int main(int argc, char **argv) {
+  constexpr std::string_view bench_flag = "--bench=";
+  std::optional<std::string_view> bench_output;
+  std::vector<std::string_view> names;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg.starts_with(bench_flag)) {
+      bench_output = arg.substr(bench_flag.size());
+    } else {
+      names.push_back(arg);
+    }
+  }
+
+  if (bench_output.has_value()) {
+    return aoc::bench::runAll(names, bench_output.value());
+  }
+  return aoc::runSolutions(names) == 0 ? 0 : 1;
+}
@@ -1,32 +1,194 @@
+#include <bit>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <random>
+#include <string>
 
 #include <libs/util.hpp>
 
-void part1(const std::vector<char>& input);
-void part2(const std::vector<char>& input);
+namespace {
 
+// Number of '(' and ')' bytes. Anything else, including whitespace, is ignored.
+struct Brackets {
+  U64 open;
+  U64 close;
+};
+
+// Counts 64 bytes at a time with compare + movemask + popcount. 'width' picks the kernel:
+// 32 for AVX2, 16 for SSE2, 1 for the scalar loop, 0 for the best one the CPU supports.
+Brackets countBrackets(const std::string_view input, const std::size_t width = 0);
+
+I32 part1(const std::string_view input);
+U32 part2(const std::span<const char> input);
+
+// Original byte by byte loop over the whitespace-filtered input, kept as a baseline
+I32 part1_scalar(const std::span<const char> input);
+
+// Random brackets with a newline every 'line' bytes
+[[maybe_unused]] std::string generateBrackets(const std::size_t size, const std::size_t line, const U32 seed);
+
+const aoc::Registrar registrar({
+  "day1",
+  "input/day1.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.view()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.singleLine()); }
+});
+
+const aoc::bench::Registrar variants({
+  {"day1", "part1_scalar", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_scalar(file.singleLine()); }},
+  {"day1", "part1_sse2", [](const aoc::MappedInput &file) -> aoc::Answer {
+    const Brackets brackets = countBrackets(file.view(), 16);
+    return static_cast<I32>(brackets.open - brackets.close);
+  }}
+});
+
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<char> input = aoc::getLineInput<char>("input/day1.dat");
-  part1(input);
-  part2(input);
+  const aoc::MappedInput file("input/day1.dat");
+  std::cout << "Current Floor: " << part1(file.view()) << std::endl;
+  const U32 position = part2(file.singleLine());
+  if (position != 0) {
+    std::cout << "Character at position " << position << " caused Santa to enter the basement." << std::endl;
+  }
+
+  // Scalar vs vector kernels over a random stream of the given size in bytes
+  // Example: `SYNTHETIC=1000000000 make day1`
+  if (const char *synthetic = std::getenv("SYNTHETIC")) {
+    const std::size_t size = aoc::parse<std::size_t>(std::string_view(synthetic)).value;
+    const std::string stream = generateBrackets(size, 80, 2015);
+    for (const std::size_t width : {1, 16, 32}) {
+      if (width == 32 && !aoc::cpu::hasAvx2()) {
+        continue;
+      }
+      const auto start = std::chrono::high_resolution_clock::now();
+      const Brackets brackets = countBrackets(stream, width);
+      const std::chrono::duration<F32, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+      std::cout << "(Synthetic " << size << " bytes, " << (width == 1 ? "scalar" : width == 16 ? "SSE2" : "AVX2") << ") Floor "
+                << static_cast<I64>(brackets.open - brackets.close) << " in " << elapsed.count() << " ms ("
+                << size / (elapsed.count() * 1e6F) << " GB/s)" << std::endl;
+    }
+  }
   return 0;
 }
+#endif
+
+namespace {
+
+Brackets countBracketsScalar(const char *data, const std::size_t size) {
+  Brackets brackets{0, 0};
+  for (std::size_t i = 0; i < size; ++i) {
+    brackets.open += (data[i] == '(');
+    brackets.close += (data[i] == ')');
+  }
+  return brackets;
+}
+
+#ifdef AOC_X86
+AOC_TARGET("avx2,popcnt") Brackets countBracketsAvx2(const char *data, const std::size_t size) {
+  const __m256i open = _mm256_set1_epi8('(');
+  const __m256i close = _mm256_set1_epi8(')');
+  Brackets brackets{0, 0};
+  std::size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+    const U64 opens = static_cast<U32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, open)))
+                    | static_cast<U64>(static_cast<U32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, open)))) << 32;
+    const U64 closes = static_cast<U32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, close)))
+                     | static_cast<U64>(static_cast<U32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, close)))) << 32;
+    brackets.open += std::popcount(opens);
+    brackets.close += std::popcount(closes);
+  }
+  const Brackets tail = countBracketsScalar(data + i, size - i);
+  return Brackets{brackets.open + tail.open, brackets.close + tail.close};
+}
+
+// Each 16-byte lane is loaded once and compared against both brackets. Inlined into the
+// wrappers below so popcount compiles to one instruction wherever the CPU has it.
+[[gnu::always_inline]] inline Brackets countBracketsSse2Blocks(const char *data, const std::size_t size) {
+  const __m128i open = _mm_set1_epi8('(');
+  const __m128i close = _mm_set1_epi8(')');
+  Brackets brackets{0, 0};
+  std::size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    U64 opens = 0;
+    U64 closes = 0;
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lane * 16));
+      opens |= static_cast<U64>(static_cast<U32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, open)))) << (lane * 16);
+      closes |= static_cast<U64>(static_cast<U32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, close)))) << (lane * 16);
+    }
+    brackets.open += std::popcount(opens);
+    brackets.close += std::popcount(closes);
+  }
+  const Brackets tail = countBracketsScalar(data + i, size - i);
+  return Brackets{brackets.open + tail.open, brackets.close + tail.close};
+}
+
+AOC_TARGET("sse2,popcnt") Brackets countBracketsSse2Popcnt(const char *data, const std::size_t size) {
+  return countBracketsSse2Blocks(data, size);
+}
+
+Brackets countBracketsSse2(const char *data, const std::size_t size) {
+  return countBracketsSse2Blocks(data, size);
+}
+#endif
+
+Brackets countBrackets(const std::string_view input, const std::size_t width) {
+#ifdef AOC_X86
+  if ((width == 0 || width == 32) && aoc::cpu::hasAvx2()) {
+    return countBracketsAvx2(input.data(), input.size());
+  }
+  if (width == 0 || width == 16) {
+    return aoc::cpu::hasPopcnt() ? countBracketsSse2Popcnt(input.data(), input.size()) : countBracketsSse2(input.data(), input.size());
+  }
+#endif
+  return countBracketsScalar(input.data(), input.size());
+}
 
-void part1(const std::vector<char>& input) {
+// Works on the raw mapped file: brackets are counted wherever they are and whitespace never matches
+I32 part1(const std::string_view input) {
+  const Brackets brackets = countBrackets(input);
+  return static_cast<I32>(brackets.open) - static_cast<I32>(brackets.close);
+}
+
+I32 part1_scalar(const std::span<const char> input) {
   I32 floor = 0;
   for (U32 i = 0; i < input.size(); ++i) {
     input[i] == '(' ? ++floor : --floor;
   }
-  std::cout << "Current Floor: " << floor << std::endl;
+  return floor;
 }
 
-void part2(const std::vector<char>& input) {
+// Returns the 1-based position of the character that first enters the basement, or 0 if none does.
+U32 part2(const std::span<const char> input) {
   I32 floor = 0;
   for (U32 i = 0; i < input.size(); ++i) {
     input[i] == '(' ? ++floor : --floor;
     if (floor < 0) {
-      std::cout << "Character at position " << i + 1 << " caused Santa to enter the basement." << std::endl;
-      break;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+std::string generateBrackets(const std::size_t size, const std::size_t line, const U32 seed) {
+  std::mt19937 rng(seed);
+  std::string brackets(size, '\n');
+  U32 bits = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    if ((i + 1) % line == 0) {
+      continue;
+    }
+    if (i % 32 == 0) {
+      bits = rng();
     }
+    brackets[i] = (bits >> (i % 32)) & 1 ? '(' : ')';
   }
+  return brackets;
+}
+
 }
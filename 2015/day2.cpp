@@ -7,26 +7,45 @@
 
 #include <libs/util.hpp>
 
-void part1(const std::vector<std::string> &input);
-void part2(const std::vector<std::string> &input);
+namespace {
 
+U64 part1(const std::vector<std::string_view> &input);
+U64 part2(const std::vector<std::string_view> &input);
+
+std::array<U64, 3> parseDimensions(const std::string_view line);
+
+const aoc::Registrar registrar({
+  "day2",
+  "input/day2.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.lines()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.lines()); }
+});
+
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<std::string> input = aoc::getMultiLineInput("input/day2.dat");
-  part1(input);
-  part2(input);
+  const aoc::MappedInput file("input/day2.dat");
+  const std::vector<std::string_view> input = file.lines();
+  std::cout << "Elves will need '" << part1(input) << "' square feet of paper." << std::endl;
+  std::cout << "Elves will need '" << part2(input) << "' feet of ribbon." << std::endl;
   return 0;
 }
+#endif
+
+namespace {
 
-void part1(const std::vector<std::string> &input) {
+// Parses a "LxWxH" line
+std::array<U64, 3> parseDimensions(const std::string_view line) {
+  const std::optional<std::array<U64, 3>> dimensions = aoc::parseFields<U64, 3>(line, 'x');
+  RUNTIME_ASSERT_MSG(dimensions, line);
+  return *dimensions;
+}
+
+U64 part1(const std::vector<std::string_view> &input) {
   U64 square_feet = 0;
   for (const std::string_view line : input) {
-    const std::size_t pos1 = line.find('x', 0);
-    const std::size_t pos2 = line.find('x', pos1+1);
-    const std::size_t pos3 = line.find('x', pos2+1);
-
-    const U64 v1 = std::stoul(line.substr(0, pos1).data(), nullptr, 10);
-    const U64 v2 = std::stoul(line.substr(pos1+1, pos2).data(), nullptr, 10);
-    const U64 v3 = std::stoul(line.substr(pos2+1, pos3).data(), nullptr, 10);
+    const auto [v1, v2, v3] = parseDimensions(line);
 
     const std::array<U64, 3> s3 = {v1*v2, v2*v3, v3*v1};
     const U64 surface_area = 2 * std::accumulate(s3.cbegin(), s3.cend(), 0);
@@ -34,21 +53,13 @@ void part1(const std::vector<std::string> &input) {
 
     square_feet += surface_area + extra_side;
   }
-  std::cout << "Elves will need '" << square_feet << "' square feet of paper." << std::endl;
+  return square_feet;
 }
 
-void part2(const std::vector<std::string> &input) {
+U64 part2(const std::vector<std::string_view> &input) {
   U64 feet = 0;
   for (const std::string_view line : input) {
-    const std::size_t pos1 = line.find('x', 0);
-    const std::size_t pos2 = line.find('x', pos1+1);
-    const std::size_t pos3 = line.find('x', pos2+1);
-
-    std::array<U64, 3> s3 = {
-      std::stoul(line.substr(0, pos1).data(), nullptr, 10),
-      std::stoul(line.substr(pos1 + 1, pos2).data(), nullptr, 10),
-      std::stoul(line.substr(pos2 + 1, pos3).data(), nullptr, 10)
-    };
+    std::array<U64, 3> s3 = parseDimensions(line);
     feet += s3[0]*s3[1]*s3[2]; // volume
 
     const U64* max_element = std::max_element(s3.cbegin(), s3.cend()); // find max element
@@ -58,5 +69,7 @@ void part2(const std::vector<std::string> &input) {
     *min_element_ptr += *max_element; // make original min element larger
     feet += 2 * (*std::min_element(s3.cbegin(), s3.cend())); // find new min element (originally second min element)
   }
-  std::cout << "Elves will need '" << feet << "' feet of ribbon." << std::endl;
+  return feet;
+}
+
 }
@@ -1,186 +1,402 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <random>
+#include <stdexcept>
 #include <string>
-#include <sstream>
-
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
 
 #include <libs/util.hpp>
 
-void part1(const std::vector<char>& input);
-void part2(const std::vector<char>& input);
+namespace {
+
+// N walkers take turns over the stream, one move each. Positions are kept as separate x and
+// y arrays, and every byte goes through a lookup table instead of a branch: bytes that aren't
+// directions move nobody and don't pass the turn.
+template <std::size_t N>
+struct Walkers {
+  std::array<I32, N> x{};
+  std::array<I32, N> y{};
+  std::size_t next = 0; // Walker making the next move
+};
+
+// Calls visit(walker, x, y) after every byte with the position of the walker whose turn it
+// was, so a non-direction byte repeats a house that was already visited
+template <std::size_t N, typename VISIT>
+void walk(const std::span<const char> input, Walkers<N> &walkers, VISIT &&visit);
+
+// Load tests run up to this many walkers; runtime walker counts dispatch to walk<N>
+constexpr std::size_t MAX_WALKERS = 64;
+
+std::size_t part1(const std::span<const char> input);
+std::size_t part2(const std::span<const char> input);
+
+// Alternative route to the same answer: visited houses in a flat hash set
+std::size_t part2_flat(const std::span<const char> input);
+
+// Two passes: the first finds the box every walker stays in, the second marks houses in a
+// bitmap over that box. Boxes over 'budget' bytes fall back to aoc::FlatCoordSet.
+struct BitmapWalk {
+  std::size_t houses;
+  std::size_t bytes; // Bitmap or hash set
+  std::array<U64, 2> extent; // Width and height of the box
+  bool bitmap;
+};
+constexpr std::size_t BITMAP_BUDGET = 64 << 20;
+BitmapWalk walkBitmap(const std::span<const char> input, const std::size_t walkers, const std::size_t budget = BITMAP_BUDGET);
+
+// Same count with one chunk of the stream per worker. Every chunk sums its own displacement
+// per walker, an exclusive scan over the chunks gives each one its start positions, and then
+// the chunks mark their houses independently: into one shared bitmap if the box fits the
+// budget, otherwise into per-worker hash sets merged at the end.
+std::size_t walkParallel(const std::span<const char> input, const std::size_t walkers, const std::size_t workers, const std::size_t budget = BITMAP_BUDGET);
+
+// Random direction stream of 'size' bytes
+[[maybe_unused]] std::string generateDirections(const std::size_t size, const U32 seed);
+
+const aoc::Registrar registrar({
+  "day3",
+  "input/day3.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return walkBitmap(file.singleLine(), 1).houses; },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return walkBitmap(file.singleLine(), 2).houses; }
+});
 
-// Alternative routes to the same answer
-void part2_map(const std::vector<char>& input);
-void part2_set(const std::vector<char>& input);
+const aoc::bench::Registrar variants({
+  {"day3", "part1_sort", [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.singleLine()); }},
+  {"day3", "part2_sort", [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.singleLine()); }},
+  {"day3", "part2_flat", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_flat(file.singleLine()); }},
+  {"day3", "part1_parallel", [](const aoc::MappedInput &file) -> aoc::Answer { return walkParallel(file.singleLine(), 1, aoc::threadCount()); }},
+  {"day3", "part2_parallel", [](const aoc::MappedInput &file) -> aoc::Answer { return walkParallel(file.singleLine(), 2, aoc::threadCount()); }}
+});
 
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<char> input = aoc::getSingleLineInput("input/day3.dat");
-  part1(input);
-  part2(input);
-  part2_map(input);
-  part2_set(input);
+  const aoc::MappedInput file("input/day3.dat");
+  const std::span<const char> input = file.singleLine();
+  std::cout << "Number of visited houses: " << part1(input) << std::endl;
+  std::cout << "Number of visited houses next year: " << part2(input) << std::endl;
+  std::cout << "Number of visited houses next year: " << part2_flat(input) << std::endl;
+
+  // Memory of the bitmap engine vs the `houses` vector part1/part2 reserve
+  const std::size_t houses_bytes = (input.size() + 1) * sizeof(std::array<I32, 2>);
+  for (const std::size_t walkers : {1, 2}) {
+    const BitmapWalk walk = walkBitmap(input, walkers);
+    std::cout << "Number of visited houses with " << walkers << " walker(s): " << walk.houses << " ("
+              << (walk.bitmap ? "bitmap over " : "hash set, box ") << walk.extent[0] << "x" << walk.extent[1] << ": "
+              << walk.bytes << " bytes vs " << houses_bytes << " bytes for the houses vector)" << std::endl;
+  }
+  std::cout << "Number of visited houses with 1, 2, 4 ... " << MAX_WALKERS << " walkers:";
+  for (std::size_t walkers = 1; walkers <= MAX_WALKERS; walkers *= 2) {
+    std::cout << ' ' << walkBitmap(input, walkers).houses;
+  }
+  std::cout << std::endl;
+
+  // Serial vs parallel walk over a random stream of the given size in bytes
+  // Example: `SYNTHETIC=1000000000 THREADS=8 make day3`
+  if (const char *synthetic = std::getenv("SYNTHETIC")) {
+    const std::size_t size = aoc::parse<std::size_t>(std::string_view(synthetic)).value;
+    const std::string directions = generateDirections(size, 2015);
+    const std::span<const char> stream(directions.data(), directions.size());
+    for (const std::size_t walkers : {1, 2}) {
+      const auto start = std::chrono::high_resolution_clock::now();
+      const std::size_t serial = walkBitmap(stream, walkers).houses;
+      const std::chrono::duration<F32, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+      const auto start_parallel = std::chrono::high_resolution_clock::now();
+      const std::size_t parallel = walkParallel(stream, walkers, aoc::threadCount());
+      const std::chrono::duration<F32, std::milli> elapsed_parallel = std::chrono::high_resolution_clock::now() - start_parallel;
+      std::cout << "(Synthetic " << size << " bytes, " << walkers << " walker(s)) " << serial << " houses serially in "
+                << elapsed.count() << " ms, " << parallel << " houses with " << aoc::threadCount() << " threads in "
+                << elapsed_parallel.count() << " ms" << std::endl;
+    }
+  }
   return 0;
 }
+#endif
 
-void part1(const std::vector<char>& input) {
-  std::vector<std::array<I32, 2>> houses;
-  houses.reserve(input.size());
-
-  std::array<I32, 2> pos = {0,0};
-  houses.push_back(pos); // initial house
-
-  for (U32 i = 0; i < input.size(); ++i) {
-    std::array<I32, 2> move;
-    switch(input[i]) {
-      case '^': {move = {0,1}; break;}
-      case '>': {move = {1,0}; break;}
-      case 'v': {move = {0,-1}; break;}
-      case '<': {move = {-1,0}; break;}
-      default: {
-        std::cerr << "Ignoring unknown input '" << input[i] << "'" << std::endl;
-        continue;
-        }
-    }
-    pos[0] += move[0];
-    pos[1] += move[1];
-    houses.push_back(pos);
+namespace {
+
+struct Step {
+  I8 dx;
+  I8 dy;
+  U8 turn; // 1 if the byte is a move
+};
+
+constexpr std::array<Step, 256> STEPS = []() {
+  std::array<Step, 256> steps{};
+  steps['^'] = {0, 1, 1};
+  steps['>'] = {1, 0, 1};
+  steps['v'] = {0, -1, 1};
+  steps['<'] = {-1, 0, 1};
+  return steps;
+}();
+
+template <std::size_t N, typename VISIT>
+void walk(const std::span<const char> input, Walkers<N> &walkers, VISIT &&visit) {
+  std::size_t next = walkers.next;
+  for (const char ch : input) {
+    const Step step = STEPS[static_cast<UCHAR>(ch)];
+    walkers.x[next] += step.dx;
+    walkers.y[next] += step.dy;
+    visit(next, walkers.x[next], walkers.y[next]);
+    next += step.turn;
+    next = (next == N) ? 0 : next;
   }
+  walkers.next = next;
+}
 
-  // sort vector, move duplicates to end of vector, remove duplicates
-  std::sort(houses.begin(), houses.end());
-  const auto beginning_of_dupes = std::unique(houses.begin(), houses.end());
-  houses.erase(beginning_of_dupes, houses.end());
+// Runs func.template operator()<N>() with N == walkers
+template <typename FUNC, std::size_t... I>
+void withWalkers(const std::size_t walkers, FUNC &&func, std::index_sequence<I...>) {
+  const bool dispatched = ((walkers == I + 1 && (func.template operator()<I + 1>(), true)) || ...);
+  if (!dispatched) {
+    throw std::invalid_argument("Walker count must be between 1 and " + std::to_string(MAX_WALKERS));
+  }
+}
 
-  std::cout << "Number of visited houses: " << houses.size() << std::endl;
+template <typename FUNC>
+void withWalkers(const std::size_t walkers, FUNC &&func) {
+  withWalkers(walkers, std::forward<FUNC>(func), std::make_index_sequence<MAX_WALKERS>{});
 }
 
-void part2(const std::vector<char>& input) {
+// Sort, move duplicates to the end, and count what's left
+template <std::size_t N>
+std::size_t countSorted(const std::span<const char> input) {
   std::vector<std::array<I32, 2>> houses;
-  houses.reserve(input.size());
-
-  std::array<I32, 2> santa = {0,0};
-  std::array<I32, 2> robot = {0,0};
-  houses.push_back(santa); // initial house
-
-  bool move_santa = true;
-  for (U32 i = 0; i < input.size(); ++i) {
-    std::array<I32, 2> move;
-    switch(input[i]) {
-      case '^': {move = {0,1}; break;}
-      case '>': {move = {1,0}; break;}
-      case 'v': {move = {0,-1}; break;}
-      case '<': {move = {-1,0}; break;}
-      default: {
-        std::cerr << "Ignoring unknown input '" << input[i] << "'" << std::endl;
-        continue;
-        }
-    }
+  houses.reserve(input.size() + 1);
+  houses.push_back({0,0}); // initial house
 
-    if (move_santa) {
-      santa[0] += move[0];
-      santa[1] += move[1];
-      houses.push_back(santa);
-    } else {
-      robot[0] += move[0];
-      robot[1] += move[1];
-      houses.push_back(robot);
-    }
-    move_santa = !move_santa;
-  }
+  Walkers<N> walkers;
+  walk(input, walkers, [&houses](const std::size_t, const I32 x, const I32 y) { houses.push_back({x, y}); });
 
-  // sort vector, move duplicates to end of vector, remove duplicates
   std::sort(houses.begin(), houses.end());
   const auto beginning_of_dupes = std::unique(houses.begin(), houses.end());
   houses.erase(beginning_of_dupes, houses.end());
 
-  std::cout << "Number of visited houses next year: " << houses.size() << std::endl;
+  return houses.size();
 }
 
-void part2_map(const std::vector<char>& input) {
-  std::unordered_map<std::string, bool> houses;
-  houses.reserve(input.size());
+std::size_t part1(const std::span<const char> input) {
+  return countSorted<1>(input);
+}
 
-  const auto to_str = [](std::array<I32, 2> pos) {
-    std::stringstream ss;
-    ss << pos[0] << "_" << pos[1];
-    return ss.str();
-  };
+std::size_t part2(const std::span<const char> input) {
+  return countSorted<2>(input);
+}
+
+std::size_t part2_flat(const std::span<const char> input) {
+  aoc::FlatCoordSet houses(input.size() + 1);
+  houses.insert(0, 0); // initial house
 
-  std::array<I32, 2> santa = {0,0};
-  std::array<I32, 2> robot = {0,0};
-  houses.insert({to_str(santa), true}); // initial house
-
-  bool move_santa = true;
-  for (U32 i = 0; i < input.size(); ++i) {
-    std::array<I32, 2> move;
-    switch(input[i]) {
-      case '^': {move = {0,1}; break;}
-      case '>': {move = {1,0}; break;}
-      case 'v': {move = {0,-1}; break;}
-      case '<': {move = {-1,0}; break;}
-      default: {
-        std::cerr << "Ignoring unknown input '" << input[i] << "'" << std::endl;
-        continue;
-        }
+  Walkers<2> walkers;
+  walk(input, walkers, [&houses](const std::size_t, const I32 x, const I32 y) { houses.insert(x, y); });
+
+  return houses.size();
+}
+
+// Bounding box as min x, max x, min y, max y
+using Box = std::array<I32, 4>;
+
+Box grow(const Box &box, const I32 x, const I32 y) {
+  return {std::min(box[0], x), std::max(box[1], x), std::min(box[2], y), std::max(box[3], y)};
+}
+
+// Bitmap over a box, if it fits the budget
+class HouseBitmap {
+private:
+  Box box;
+  U64 width;
+  U64 height;
+
+public:
+  std::vector<U64> bits;
+
+  HouseBitmap(const Box &b) : box(b), width(static_cast<U64>(I64{b[1]} - b[0] + 1)), height(static_cast<U64>(I64{b[3]} - b[2] + 1)) {}
+
+  bool fits(const std::size_t budget) const {
+    return (width <= budget * 8 / height) && (width * height + 63) / 64 * sizeof(U64) <= budget;
+  }
+
+  void allocate() {
+    bits.assign((width * height + 63) / 64, 0);
+  }
+
+  U64 index(const I32 x, const I32 y) const {
+    return static_cast<U64>(I64{y} - box[2]) * width + static_cast<U64>(I64{x} - box[0]);
+  }
+
+  std::array<U64, 2> extent() const { return {width, height}; }
+};
+
+// Per-walker extents, relative to where each walker started
+struct ExtentVisitor {
+  std::vector<Box> extents;
+
+  void operator()(const std::size_t walker, const I32 x, const I32 y) {
+    extents[walker] = grow(extents[walker], x, y);
+  }
+
+  Box box() const {
+    Box box = {0,0,0,0};
+    for (const Box &e : extents) {
+      box = grow(grow(box, e[0], e[2]), e[1], e[3]);
     }
+    return box;
+  }
+};
+
+// Marks houses in the bitmap if there is one, otherwise in the hash set. When several threads
+// share the bitmap the bits are set atomically and counted afterwards.
+struct MarkVisitor {
+  HouseBitmap *bitmap;
+  aoc::FlatCoordSet *set;
+  bool shared;
+  std::size_t houses = 0; // New bits, unless shared
 
-    if (move_santa) {
-      santa[0] += move[0];
-      santa[1] += move[1];
-      houses.insert({to_str(santa), true});
-    } else {
-      robot[0] += move[0];
-      robot[1] += move[1];
-      houses.insert({to_str(robot), true});
+  void operator()(const std::size_t, const I32 x, const I32 y) {
+    if (bitmap == nullptr) {
+      set->insert(x, y);
+      return;
     }
-    move_santa = !move_santa;
+    const U64 index = bitmap->index(x, y);
+    U64 &word = bitmap->bits[index / 64];
+    const U64 bit = U64{1} << (index % 64);
+    if (shared) {
+      std::atomic_ref<U64>(word).fetch_or(bit, std::memory_order_relaxed);
+      return;
+    }
+    houses += (word & bit) == 0; // Test-and-set, no branch
+    word |= bit;
   }
+};
 
-  std::cout << "Number of visited houses next year: " << houses.size() << std::endl;
+// walk<N> for a runtime walker count, from and back into 'positions'. Returns the walker whose
+// turn is next. Only the loop itself is instantiated per N, once per visitor type.
+template <typename VISIT>
+std::size_t walkFrom(const std::span<const char> input, std::vector<std::array<I32, 2>> &positions, VISIT &visit) {
+  std::size_t next = 0;
+  withWalkers(positions.size(), [&]<std::size_t N>() {
+    Walkers<N> walkers;
+    for (std::size_t walker = 0; walker < N; ++walker) {
+      walkers.x[walker] = positions[walker][0];
+      walkers.y[walker] = positions[walker][1];
+    }
+    walk(input, walkers, visit);
+    for (std::size_t walker = 0; walker < N; ++walker) {
+      positions[walker] = {walkers.x[walker], walkers.y[walker]};
+    }
+    next = walkers.next;
+  });
+  return next;
 }
 
-void part2_set(const std::vector<char>& input) {
-  std::unordered_set<std::string> houses;
-  houses.reserve(input.size());
+BitmapWalk walkBitmap(const std::span<const char> input, const std::size_t walkers, const std::size_t budget) {
+  // Pass 1: box of every walker, starting from the origin house
+  std::vector<std::array<I32, 2>> positions(walkers, {0,0});
+  ExtentVisitor extents{std::vector<Box>(walkers, {0,0,0,0})};
+  walkFrom(input, positions, extents);
+
+  // Pass 2: mark every house
+  HouseBitmap bitmap(extents.box());
+  aoc::FlatCoordSet set;
+  const bool dense = bitmap.fits(budget);
+  if (dense) {
+    bitmap.allocate();
+  } else {
+    set = aoc::FlatCoordSet(input.size() + 1);
+  }
+  MarkVisitor mark{dense ? &bitmap : nullptr, &set, false};
+  mark(0, 0, 0);
+  std::fill(positions.begin(), positions.end(), std::array<I32, 2>{0,0});
+  walkFrom(input, positions, mark);
 
-  const auto to_str = [](std::array<I32, 2> pos) {
-    std::stringstream ss;
-    ss << pos[0] << "_" << pos[1];
-    return ss.str();
+  if (dense) {
+    return {mark.houses, bitmap.bits.size() * sizeof(U64), bitmap.extent(), true};
+  }
+  return {set.size(), set.memoryBytes(), bitmap.extent(), false};
+}
+
+std::size_t walkParallel(const std::span<const char> input, const std::size_t walkers, const std::size_t workers, const std::size_t budget) {
+  // Per chunk, indexed by the chunk's own walker order (its first move belongs to local walker 0)
+  struct Chunk {
+    std::vector<std::array<I32, 2>> displacement;
+    ExtentVisitor extents;
+    std::size_t turn = 0; // Local walker whose turn it is after the chunk
+    std::vector<std::array<I32, 2>> start; // Filled in by the scan
+  };
+  std::vector<Chunk> chunks(workers);
+  const auto chunkOf = [&](const std::size_t worker) {
+    const std::size_t length = input.size() / workers;
+    return input.subspan(worker * length, worker + 1 == workers ? input.size() - worker * length : length);
   };
 
-  std::array<I32, 2> santa = {0,0};
-  std::array<I32, 2> robot = {0,0};
-  houses.insert(to_str(santa)); // initial house
-
-  bool move_santa = true;
-  for (U32 i = 0; i < input.size(); ++i) {
-    std::array<I32, 2> move;
-    switch(input[i]) {
-      case '^': {move = {0,1}; break;}
-      case '>': {move = {1,0}; break;}
-      case 'v': {move = {0,-1}; break;}
-      case '<': {move = {-1,0}; break;}
-      default: {
-        std::cerr << "Ignoring unknown input '" << input[i] << "'" << std::endl;
-        continue;
-        }
+  // Pass 1: displacement and extents of every chunk
+  aoc::runWorkers(workers, [&](const std::size_t worker) {
+    Chunk &chunk = chunks[worker];
+    chunk.displacement.assign(walkers, {0,0});
+    chunk.extents.extents.assign(walkers, {0,0,0,0});
+    chunk.turn = walkFrom(chunkOf(worker), chunk.displacement, chunk.extents);
+  });
+
+  // Exclusive scan: a chunk's local walker l is global walker (phase + l) % walkers, where the
+  // phase counts the moves before the chunk
+  std::vector<std::array<I32, 2>> pos(walkers, {0,0});
+  Box box = {0,0,0,0};
+  std::size_t phase = 0;
+  for (Chunk &chunk : chunks) {
+    chunk.start.resize(walkers);
+    for (std::size_t local = 0; local < walkers; ++local) {
+      std::array<I32, 2> &p = pos[(phase + local) % walkers];
+      const Box &e = chunk.extents.extents[local];
+      chunk.start[local] = p;
+      box = grow(grow(box, p[0] + e[0], p[1] + e[2]), p[0] + e[1], p[1] + e[3]);
+      p[0] += chunk.displacement[local][0];
+      p[1] += chunk.displacement[local][1];
     }
+    phase = (phase + chunk.turn) % walkers;
+  }
 
-    if (move_santa) {
-      santa[0] += move[0];
-      santa[1] += move[1];
-      houses.insert(to_str(santa));
-    } else {
-      robot[0] += move[0];
-      robot[1] += move[1];
-      houses.insert(to_str(robot));
+  // Pass 2: every chunk replays its moves from its start positions, into one shared bitmap
+  // or into a hash set per worker that gets merged at the end
+  HouseBitmap bitmap(box);
+  const bool dense = bitmap.fits(budget);
+  if (dense) {
+    bitmap.allocate();
+  }
+  std::vector<aoc::FlatCoordSet> sets(dense ? 1 : workers);
+  sets[0].insert(0, 0);
+  aoc::runWorkers(workers, [&](const std::size_t worker) {
+    MarkVisitor mark{dense ? &bitmap : nullptr, dense ? nullptr : &sets[worker], true};
+    mark(0, 0, 0);
+    walkFrom(chunkOf(worker), chunks[worker].start, mark);
+  });
+
+  if (dense) {
+    std::size_t houses = 0;
+    for (const U64 word : bitmap.bits) {
+      houses += std::popcount(word);
     }
-    move_santa = !move_santa;
+    return houses;
+  }
+  for (std::size_t worker = 1; worker < workers; ++worker) {
+    sets[worker].forEach([&sets](const I32 x, const I32 y) { sets[0].insert(x, y); });
   }
+  return sets[0].size();
+}
+
+std::string generateDirections(const std::size_t size, const U32 seed) {
+  static constexpr std::array<char, 4> DIRECTIONS = {'^', '>', 'v', '<'};
+  std::mt19937 rng(seed);
+  std::string directions(size, ' ');
+  for (char &ch : directions) {
+    ch = DIRECTIONS[rng() % DIRECTIONS.size()];
+  }
+  return directions;
+}
 
-  std::cout << "Number of visited houses next year: " << houses.size() << std::endl;
 }
@@ -1,8 +1,16 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 // Documentation: https://docs.openssl.org/3.0/man3
 // evp.h - high-level cryptographic functions
@@ -10,35 +18,120 @@
 
 #include <libs/util.hpp>
 
+namespace {
+
 // TODO :: Define custom destructor for the EVP_MD_CTX pointer.
 
-void part1(const std::string_view key);
-void part2(const std::string_view key);
+// Multi-lane MD5 search, every answer double-checked with OpenSSL. Part 2 starts from the
+// part 1 answer, since a hash with six leading zeros also has five.
+U64 part1(const std::string_view key);
+U64 part2(const std::string_view key);
+// Reference: one OpenSSL digest and hex string per candidate
+U64 part1_openssl(const std::string_view key);
 
 // Note: unsigned char (UCHAR) important in bitwise ops and crypto funcs
 std::string toHex(const UCHAR ch);
 std::string toMd5(const std::string_view key, EVP_MD_CTX *context);
-void compute_md5_suffix(const std::string_view key, const U8 prefix_zeroes);
+U64 compute_md5_suffix(const std::string_view key, const U8 prefix_zeroes);
+
+// MD5 state after every full 64-byte block of the key, plus the bytes left over
+struct KeyPrefix {
+  std::string_view key;
+  std::array<U32, 4> state;
+  std::string_view tail;
+
+  explicit KeyPrefix(const std::string_view key);
+  // Whether key + decimal(nonce) still ends in a single padded block after the midstate
+  bool fits(const U64 nonce) const;
+};
+
+// Hashes 16/8/4 candidates per kernel call (lanes == 0 picks the widest the CPU supports,
+// unsupported widths run one lane at a time)
+U64 searchLanes(const std::string_view key, const U8 zeroes, const std::size_t lanes = 0);
+// OpenSSL agrees that 'nonce' is the answer, otherwise throws
+U64 verified(const std::string_view key, const U64 nonce, const U8 zeroes);
 
+// First match in [first, last) whose first digest word satisfies (word & mask) == target,
+// hashed by one lane kernel
+using RangeSearch = std::optional<U64> (*)(const KeyPrefix &prefix, const U32 mask, const U32 target, const U64 first, const U64 last);
+RangeSearch rangeSearch(const std::size_t lanes);
+// Same for any predicate. Predicates past the first word, and messages that need two blocks,
+// are hashed with OpenSSL instead.
+std::optional<U64> searchRange(const RangeSearch search, const KeyPrefix &prefix, const aoc::HashPredicate &predicate, const U64 first, const U64 last);
+
+// Parallel search for 'zeroes' leading zeros from 'start'. CHECKPOINT=<path> saves and resumes
+// long searches, PROGRESS=<seconds> prints progress to stderr.
+constexpr U64 CHUNK = 1 << 16;
+aoc::HashSearch::Config searchConfig(const std::string_view key, const U8 zeroes, const U64 start);
+U64 searchParallel(const std::string_view key, const U8 zeroes, const U64 start, aoc::HashSearch::Config config, std::vector<aoc::HashSearch::WorkerStats> *stats = nullptr);
+
+std::string_view toKey(const aoc::MappedInput &file) {
+  const std::span<const char> input = file.singleLine();
+  return std::string_view(input.data(), input.size());
+}
+
+const aoc::Registrar registrar({
+  "day4",
+  "input/day4.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(toKey(file)); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(toKey(file)); }
+});
+
+const aoc::bench::Registrar variants({
+  {"day4", "part1_openssl", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_openssl(toKey(file)); }},
+  {"day4", "part1_single_thread", [](const aoc::MappedInput &file) -> aoc::Answer { return searchLanes(toKey(file), 5); }},
+  {"day4", "part2_single_thread", [](const aoc::MappedInput &file) -> aoc::Answer { return searchLanes(toKey(file), 6); }}
+});
+
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<char> input = aoc::getSingleLineInput("input/day4.dat");
-  std::string key(input.begin(), input.end());
-  part1(key);
-  part2(key);
+  const aoc::MappedInput file("input/day4.dat");
+  const std::string_view key = toKey(file);
+  std::cout << "Solving part 1 ... " << std::flush;
+  std::cout << "Hash challenge solved with additional number '" << part1(key) << "'" << std::endl;
+  std::cout << "Solving part 2 ... " << std::flush;
+  std::cout << "Hash challenge solved with additional number '" << part2(key) << "'" << std::endl;
+
+  const auto time = [](const auto &func) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    func();
+    return std::chrono::duration<F64, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+  };
+  std::cout << "Elapsed time part 1 (OpenSSL):\t" << time([&]{ part1_openssl(key); }) << " ms" << std::endl;
+  for (const std::size_t lanes : {1, 4, 8, 16}) {
+    std::cout << "Elapsed time part 1 (" << lanes << " lanes):\t" << time([&]{ searchLanes(key, 5, lanes); }) << " ms" << std::endl;
+  }
+
+  // Throughput of the parallel search (THREADS=<n> overrides the thread count)
+  std::vector<aoc::HashSearch::WorkerStats> stats;
+  const aoc::HashSearch::Config config = searchConfig(key, 6, 0);
+  std::cout << "Elapsed time part 2 (" << config.workers << " threads):\t" << time([&]{ searchParallel(key, 6, 0, config, &stats); }) << " ms" << std::endl;
+  for (std::size_t worker = 0; worker < stats.size(); ++worker) {
+    std::cout << "\tThread " << worker << ": " << stats[worker].hashes << " hashes, "
+              << stats[worker].hashes / stats[worker].seconds / 1e6 << " MH/s" << std::endl;
+  }
   return 0;
 }
+#endif
 
-void part1(const std::string_view key) {
-  std::cout << "Solving part 1 ... " << std::flush;
-  compute_md5_suffix(key, 5);
+namespace {
+
+U64 part1(const std::string_view key) {
+  return verified(key, searchParallel(key, 5, 0, searchConfig(key, 5, 0)), 5);
 }
 
-void part2(const std::string_view key) {
-  std::cout << "Solving part 2 ... " << std::flush;
-  compute_md5_suffix(key, 6);
+U64 part2(const std::string_view key) {
+  const U64 start = part1(key);
+  return verified(key, searchParallel(key, 6, start, searchConfig(key, 6, start)), 6);
+}
+
+U64 part1_openssl(const std::string_view key) {
+  return compute_md5_suffix(key, 5);
 }
 
-void compute_md5_suffix(const std::string_view key, const U8 prefix_zeroes) {
+U64 compute_md5_suffix(const std::string_view key, const U8 prefix_zeroes) {
   EVP_MD_CTX *context = EVP_MD_CTX_new();
   if (context == nullptr) {
     std::cerr << "Failed to create message digest context!" << std::endl;
@@ -56,7 +149,7 @@ void compute_md5_suffix(const std::string_view key, const U8 prefix_zeroes) {
   }
 
   EVP_MD_CTX_free(context);
-  std::cout << "Hash challenge solved with additional number '" << i << "' giving MD5(" << oss.str() << ") = " << md5_str << std::endl;
+  return i;
 }
 
 std::string toHex(const UCHAR ch) {
@@ -92,3 +185,319 @@ std::string toMd5(const std::string_view key, EVP_MD_CTX *context) {
   }
   return md5_str;
 }
+
+U64 verified(const std::string_view key, const U64 nonce, const U8 zeroes) {
+  EVP_MD_CTX *context = EVP_MD_CTX_new();
+  if (context == nullptr) {
+    std::cerr << "Failed to create message digest context!" << std::endl;
+    exit(1);
+  }
+  const std::string md5_str = toMd5(std::string(key) + std::to_string(nonce), context);
+  EVP_MD_CTX_free(context);
+  if (md5_str.substr(0, zeroes) != std::string(zeroes, '0')) {
+    throw std::runtime_error("OpenSSL disagrees with the lane search for nonce " + std::to_string(nonce));
+  }
+  return nonce;
+}
+
+////////////////////////////////////////////////////////////////
+// Multi-lane MD5. Every lane hashes its own single-block message;
+// the lanes live in a GCC/Clang vector so each step is one
+// instruction per ISA register width.
+////////////////////////////////////////////////////////////////
+
+template <std::size_t LANES>
+struct Md5Lanes {
+  typedef U32 Vec __attribute__((vector_size(sizeof(U32) * LANES)));
+};
+
+constexpr std::array<U32, 64> MD5_K = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+constexpr std::array<U32, 16> MD5_SHIFT = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+constexpr std::array<U32, 4> MD5_INIT = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+constexpr std::size_t md5Word(const std::size_t step) {
+  switch (step / 16) {
+    case 0: return step;
+    case 1: return (5 * step + 1) % 16;
+    case 2: return (3 * step + 5) % 16;
+    default: return (7 * step) % 16;
+  }
+}
+
+template <std::size_t STEP, typename VEC>
+[[gnu::always_inline]] inline void md5Step(VEC &a, const VEC &b, const VEC &c, const VEC &d, const VEC *words) {
+  VEC f;
+  if constexpr (STEP < 16) {
+    f = d ^ (b & (c ^ d));
+  }
+  else if constexpr (STEP < 32) {
+    f = c ^ (d & (b ^ c));
+  }
+  else if constexpr (STEP < 48) {
+    f = b ^ c ^ d;
+  }
+  else {
+    f = c ^ (b | ~d);
+  }
+  constexpr U32 shift = MD5_SHIFT[(STEP / 16) * 4 + STEP % 4];
+  const VEC x = a + f + MD5_K[STEP] + words[md5Word(STEP)];
+  a = b + ((x << shift) | (x >> (32 - shift)));
+}
+
+template <typename VEC, std::size_t... GROUP>
+[[gnu::always_inline]] inline void md5Groups(VEC &a, VEC &b, VEC &c, VEC &d, const VEC *words, std::index_sequence<GROUP...>) {
+  ((md5Step<4 * GROUP>(a, b, c, d, words), md5Step<4 * GROUP + 1>(d, a, b, c, words),
+    md5Step<4 * GROUP + 2>(c, d, a, b, words), md5Step<4 * GROUP + 3>(b, c, d, a, words)), ...);
+}
+
+// One MD5 compression of a block per lane, starting from 'state'. 'words' holds message word w
+// of lane l at [w * LANES + l]. With FIRST_WORD only the first output word is produced: it is
+// final after step 60, so the last three steps are skipped. Otherwise 'digest' gets all four
+// words, laid out like 'words'.
+template <std::size_t LANES, bool FIRST_WORD>
+[[gnu::always_inline]] inline void md5Compress(const U32 *state, const U32 *words, U32 *digest) {
+  using Vec = typename Md5Lanes<LANES>::Vec;
+  Vec message[16];
+  std::memcpy(message, words, sizeof(message));
+  Vec a = Vec{} + state[0];
+  Vec b = Vec{} + state[1];
+  Vec c = Vec{} + state[2];
+  Vec d = Vec{} + state[3];
+  md5Groups(a, b, c, d, message, std::make_index_sequence<15>{});
+  md5Step<60>(a, b, c, d, message);
+  if constexpr (FIRST_WORD) {
+    a += state[0];
+    std::memcpy(digest, &a, sizeof(a));
+  }
+  else {
+    md5Step<61>(d, a, b, c, message);
+    md5Step<62>(c, d, a, b, message);
+    md5Step<63>(b, c, d, a, message);
+    a += state[0]; // 'digest' may alias 'state'
+    b += state[1];
+    c += state[2];
+    d += state[3];
+    std::memcpy(digest, &a, sizeof(a));
+    std::memcpy(digest + LANES, &b, sizeof(b));
+    std::memcpy(digest + 2 * LANES, &c, sizeof(c));
+    std::memcpy(digest + 3 * LANES, &d, sizeof(d));
+  }
+}
+
+#ifdef AOC_X86
+AOC_TARGET("avx512f") void md5FirstWordAvx512(const U32 *state, const U32 *words, U32 *digest) {
+  md5Compress<16, true>(state, words, digest);
+}
+
+AOC_TARGET("avx2") void md5FirstWordAvx2(const U32 *state, const U32 *words, U32 *digest) {
+  md5Compress<8, true>(state, words, digest);
+}
+
+AOC_TARGET("sse2") void md5FirstWordSse2(const U32 *state, const U32 *words, U32 *digest) {
+  md5Compress<4, true>(state, words, digest);
+}
+#endif
+
+void md5FirstWordScalar(const U32 *state, const U32 *words, U32 *digest) {
+  md5Compress<1, true>(state, words, digest);
+}
+
+U32 loadWord(const UCHAR *bytes) {
+  return U32{bytes[0]} | U32{bytes[1]} << 8 | U32{bytes[2]} << 16 | U32{bytes[3]} << 24;
+}
+
+KeyPrefix::KeyPrefix(const std::string_view k) : key(k), state(MD5_INIT), tail(k.substr(k.size() - k.size() % 64)) {
+  const UCHAR *bytes = reinterpret_cast<const UCHAR *>(key.data());
+  for (std::size_t block = 0; block + 64 <= key.size(); block += 64) {
+    std::array<U32, 16> words;
+    for (std::size_t w = 0; w < 16; ++w) {
+      words[w] = loadWord(bytes + block + 4 * w);
+    }
+    md5Compress<1, false>(state.data(), words.data(), state.data());
+  }
+}
+
+bool KeyPrefix::fits(const U64 nonce) const {
+  std::size_t digits = 1;
+  for (U64 rest = nonce; rest >= 10; rest /= 10) {
+    ++digits;
+  }
+  return tail.size() + digits + 9 <= 64; // 0x80 and the 64-bit length
+}
+
+// Final block of key + decimal(nonce): the key tail, the digits, 0x80 and the bit length.
+// The digits are advanced in place; the block only moves when the number grows a digit.
+class NonceBlock {
+private:
+  std::array<UCHAR, 64> bytes{};
+  std::size_t start = 0; // First digit
+  std::size_t digits = 0;
+  U64 key_length = 0;
+
+  void pad() {
+    const std::size_t end = start + digits;
+    bytes[end] = 0x80;
+    std::fill(bytes.begin() + end + 1, bytes.begin() + 56, UCHAR{0});
+    const U64 bits = 8 * (key_length + digits);
+    for (std::size_t i = 0; i < 8; ++i) {
+      bytes[56 + i] = static_cast<UCHAR>(bits >> (8 * i));
+    }
+  }
+
+public:
+  NonceBlock() = default;
+  NonceBlock(const KeyPrefix &prefix, const U64 nonce) : start(prefix.tail.size()), key_length(prefix.key.size()) {
+    std::memcpy(bytes.data(), prefix.tail.data(), prefix.tail.size());
+    char *first = reinterpret_cast<char *>(bytes.data() + start);
+    digits = std::to_chars(first, first + 20, nonce).ptr - first;
+    pad();
+  }
+
+  // Adds 'step' (at most 90, so the final carry is one digit) to the ASCII digits. Returns true if a digit was prepended, which
+  // shifts the padding, so every word changes.
+  bool advance(const U32 step) {
+    U32 carry = step;
+    for (std::size_t i = start + digits; carry != 0 && i-- > start;) {
+      const U32 value = bytes[i] - '0' + carry;
+      bytes[i] = static_cast<UCHAR>('0' + value % 10);
+      carry = value / 10;
+    }
+    if (carry == 0) {
+      return false;
+    }
+    std::memmove(bytes.data() + start + 1, bytes.data() + start, digits);
+    bytes[start] = static_cast<UCHAR>('0' + carry);
+    ++digits;
+    pad();
+    return true;
+  }
+
+  std::size_t firstDigitWord() const { return start / 4; }
+  std::size_t lastDigitWord() const { return (start + digits - 1) / 4; }
+  U32 word(const std::size_t w) const { return loadWord(bytes.data() + 4 * w); }
+};
+
+// The last batch may hash a few nonces past 'last'; they are never reported
+template <std::size_t LANES, void (*KERNEL)(const U32 *, const U32 *, U32 *)>
+std::optional<U64> searchBatches(const KeyPrefix &prefix, const U32 mask, const U32 target, const U64 first, const U64 last) {
+  static_assert(LANES <= 90, "NonceBlock::advance carries at most one new digit");
+  alignas(64) std::array<U32, 16 * LANES> words;
+  alignas(64) std::array<U32, LANES> digest;
+  std::array<NonceBlock, LANES> blocks;
+  for (std::size_t lane = 0; lane < LANES; ++lane) {
+    blocks[lane] = NonceBlock(prefix, first + lane);
+    for (std::size_t w = 0; w < 16; ++w) {
+      words[w * LANES + lane] = blocks[lane].word(w);
+    }
+  }
+
+  for (U64 base = first; base < last; base += LANES) {
+    KERNEL(prefix.state.data(), words.data(), digest.data());
+    for (std::size_t lane = 0; lane < LANES && base + lane < last; ++lane) {
+      if ((digest[lane] & mask) == target) {
+        return base + lane;
+      }
+    }
+    // Each lane steps by LANES, so usually only the word or two holding the last digits change
+    for (std::size_t lane = 0; lane < LANES; ++lane) {
+      NonceBlock &block = blocks[lane];
+      const bool moved = block.advance(LANES);
+      for (std::size_t w = (moved ? 0 : block.firstDigitWord()); w <= (moved ? 15 : block.lastDigitWord()); ++w) {
+        words[w * LANES + lane] = block.word(w);
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+RangeSearch rangeSearch(const std::size_t lanes) {
+#ifdef AOC_X86
+  if ((lanes == 0 || lanes == 16) && aoc::cpu::hasAvx512f()) {
+    return searchBatches<16, md5FirstWordAvx512>;
+  }
+  if ((lanes == 0 || lanes == 8) && aoc::cpu::hasAvx2()) {
+    return searchBatches<8, md5FirstWordAvx2>;
+  }
+  if (lanes == 0 || lanes == 4) {
+    return searchBatches<4, md5FirstWordSse2>;
+  }
+#endif
+  return searchBatches<1, md5FirstWordScalar>;
+}
+
+std::optional<U64> searchRange(const RangeSearch search, const KeyPrefix &prefix, const aoc::HashPredicate &predicate, const U64 first, const U64 last) {
+  if (predicate.length() <= 4 && prefix.fits(last + 16)) { // Batches can overshoot 'last' by up to 15
+    return search(prefix, predicate.wordMask(0), predicate.wordTarget(0), first, last);
+  }
+  // Hash whole messages instead
+  std::string message(prefix.key);
+  for (U64 nonce = first; nonce < last; ++nonce) {
+    message.resize(prefix.key.size());
+    message += std::to_string(nonce);
+    std::array<UCHAR, EVP_MAX_MD_SIZE> digest;
+    U32 length;
+    if (1 != EVP_Digest(message.data(), message.size(), digest.data(), &length, EVP_md5(), nullptr)) {
+      std::cerr << "Failed to calculate the digest for key '" << message << "'" << std::endl;
+      exit(1);
+    }
+    if (predicate(std::span<const UCHAR>(digest.data(), length))) {
+      return nonce;
+    }
+  }
+  return std::nullopt;
+}
+
+U64 searchLanes(const std::string_view key, const U8 zeroes, const std::size_t lanes) {
+  const KeyPrefix prefix(key);
+  const aoc::HashPredicate predicate = aoc::HashPredicate::leadingZeroNibbles(zeroes);
+  const RangeSearch search = rangeSearch(lanes);
+  for (U64 first = 0;; first += CHUNK) {
+    if (const std::optional<U64> found = searchRange(search, prefix, predicate, first, first + CHUNK)) {
+      return *found;
+    }
+  }
+}
+
+aoc::HashSearch::Config searchConfig(const std::string_view key, const U8 zeroes, const U64 start) {
+  aoc::HashSearch::Config config;
+  config.start = start;
+  config.chunk = CHUNK;
+  config.id = "day4 " + std::string(key) + " " + std::to_string(zeroes) + " zeros";
+  if (const char *checkpoint = std::getenv("CHECKPOINT")) {
+    config.checkpoint = std::string(checkpoint) + "." + std::to_string(zeroes);
+  }
+  if (const char *progress = std::getenv("PROGRESS")) {
+    const aoc::ParseResult<U32> seconds = aoc::parse<U32>(std::string_view(progress));
+    config.report_seconds = seconds ? seconds.value : 0;
+    config.progress = &std::cerr;
+  }
+  return config;
+}
+
+U64 searchParallel(const std::string_view key, const U8 zeroes, const U64 start, aoc::HashSearch::Config config, std::vector<aoc::HashSearch::WorkerStats> *stats) {
+  const KeyPrefix prefix(key);
+  const RangeSearch lanes = rangeSearch(0);
+  config.start = start;
+  aoc::HashSearch search(aoc::HashPredicate::leadingZeroNibbles(zeroes), config);
+  const std::optional<U64> found = search.run([&](const aoc::HashPredicate &predicate, const U64 first, const U64 last) {
+    return searchRange(lanes, prefix, predicate, first, last);
+  });
+  if (stats != nullptr) {
+    *stats = search.workerStats();
+  }
+  if (!found) {
+    throw std::runtime_error("No nonce with " + std::to_string(zeroes) + " leading zeros");
+  }
+  return *found;
+}
+
+}
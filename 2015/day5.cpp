@@ -6,8 +6,10 @@
 
 #include <libs/util.hpp>
 
-void part1(const std::vector<std::string>& input);
-void part2(const std::vector<std::string>& input);
+namespace {
+
+U32 part1(const std::vector<std::string_view> &input);
+U32 part2(const std::vector<std::string_view> &input);
 
 bool hasAtLeastNumVowels(const std::string_view str, const U8 count);
 bool hasPairs(const std::string_view str);
@@ -16,12 +18,26 @@ bool containsNoBadPairs(const std::string_view str);
 bool containsPairsNotOverlapping(const std::string_view str);
 bool containsPairWithInBetween(const std::string_view str);
 
+const aoc::Registrar registrar({
+  "day5",
+  "input/day5.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.lines()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.lines()); }
+});
+
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<std::string> input = aoc::getMultiLineInput("input/day5.dat");
-  part1(input);
-  part2(input);
+  const aoc::MappedInput file("input/day5.dat");
+  const std::vector<std::string_view> input = file.lines();
+  std::cout << "(Part 1) There are '" << part1(input) << "' nice strings" << std::endl;
+  std::cout << "(Part 2) There are '" << part2(input) << "' nice strings" << std::endl;
   return 0;
 }
+#endif
+
+namespace {
 
 bool hasAtLeastNumVowels(const std::string_view str, const U8 count) {
   static const std::array<char, 5> vowels = {'a','e','i','o','u'};
@@ -73,22 +89,24 @@ bool containsPairWithInBetween(const std::string_view str) {
   return false;
 }
 
-void part1(const std::vector<std::string>& input) {
+U32 part1(const std::vector<std::string_view> &input) {
   U32 nice = 0;
   for (const std::string_view str : input) {
     if (hasAtLeastNumVowels(str, 3) && hasPairs(str) && containsNoBadPairs(str)) {
       ++nice;
     }
   }
-  std::cout << "(Part 1) There are '" << nice << "' nice strings" << std::endl;
+  return nice;
 }
 
-void part2(const std::vector<std::string>& input) {
+U32 part2(const std::vector<std::string_view> &input) {
   U32 nice = 0;
   for (const std::string_view str : input) {
     if (containsPairsNotOverlapping(str) && containsPairWithInBetween(str)) {
       ++nice;
     }
   }
-  std::cout << "(Part 2) There are '" << nice << "' nice strings" << std::endl;
+  return nice;
+}
+
 }
@@ -2,24 +2,28 @@
 #include <array>
 #include <chrono>
 #include <bitset>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
 #include <variant>
 
 #include <libs/util.hpp>
 
+namespace {
+
 enum class Cmd {
   ON, OFF, TOGGLE
 };
 
 struct LightInstruction {
   Cmd cmd;
-  std::array<U16, 2> coord1;
-  std::array<U16, 2> coord2;
-  LightInstruction(const Cmd _cmd, const std::array<U16, 2> &_coord1, const std::array<U16, 2> &_coord2) {
+  std::array<U32, 2> coord1;
+  std::array<U32, 2> coord2;
+  LightInstruction(const Cmd _cmd, const std::array<U32, 2> &_coord1, const std::array<U32, 2> &_coord2) {
     cmd = _cmd;
     coord1 = _coord1;
     coord2 = _coord2;
@@ -71,6 +75,13 @@ struct OpsV2 {
   // Takes instructions and applies operations on 'lights' vector elements
   void applyLambda(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights) const requires TotalOpsConsumerRowRef<ROW, ON_OP, OFF_OP, TOGGLE_OP>;
   void applyVisitor(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights) const requires TotalOpsConsumerRowPtr<ROW, ON_OP, OFF_OP, TOGGLE_OP>;
+  // Same as applyLambda, but only touches rows in [first_row, last_row)
+  void applyLambdaRows(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights, const std::size_t first_row, const std::size_t last_row) const requires TotalOpsConsumerRowRef<ROW, ON_OP, OFF_OP, TOGGLE_OP>;
+  // Rows are independent, so they are split into one band per worker and each worker replays
+  // every instruction clipped to its band (no locks). Bands are reduced with 'reduce' in place
+  // and the band totals are summed.
+  template <typename REDUCE>
+  std::size_t applyParallel(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights, const REDUCE &reduce, const std::size_t workers) const requires TotalOpsConsumerRowRef<ROW, ON_OP, OFF_OP, TOGGLE_OP>;
 };
 
 template <typename ROW, typename ON_OP, typename OFF_OP, typename TOGGLE_OP>
@@ -83,62 +94,212 @@ struct OpsV2Visitor {
   void operator()(const TOGGLE_OP *op) { (*op)(row,column); }
 };
 
+// Packed bit grid with word-level row-span operations. A span only touches its two
+// edge words with a mask; everything in between is whole-word stores (AVX2 when available).
+template <U16 COLUMNS>
+class LightGrid {
+public:
+  static constexpr U16 WORDS = (COLUMNS + 63) / 64;
+  using ROW = std::array<U64, WORDS>;
+
+  explicit LightGrid(const U16 num_rows) : rows(num_rows) {}
+
+  // Column ranges are inclusive, like the puzzle coordinates
+  void setRange(const U16 row, const U16 first, const U16 last);
+  void resetRange(const U16 row, const U16 first, const U16 last);
+  void flipRange(const U16 row, const U16 first, const U16 last);
+
+  std::size_t count() const;
+
+private:
+  std::vector<ROW> rows;
+
+  template <Cmd CMD>
+  void applyRange(const U16 row, const U16 first, const U16 last);
+};
+
+// Coordinate-compressed grid. Both axes are cut at every rectangle edge, so each compressed
+// cell is a block of lights that all instructions treat alike. Work per instruction scales
+// with the number of distinct edges rather than the grid area.
+class CompressedGrid {
+public:
+  explicit CompressedGrid(const std::vector<LightInstruction> &instructions);
+
+  // Applies the instructions to one CELL per compressed cell and returns the sum of
+  // every cell value weighted by the number of lights it stands for.
+  template <typename CELL, typename ON_OP, typename OFF_OP, typename TOGGLE_OP>
+  U64 apply(const std::vector<LightInstruction> &instructions, const ON_OP &on_op, const OFF_OP &off_op, const TOGGLE_OP &toggle_op) const;
+
+private:
+  // Sorted distinct edges; cell i covers [edges[i], edges[i + 1])
+  std::vector<U64> xs;
+  std::vector<U64> ys;
+
+  static std::size_t cellIndex(const std::vector<U64> &edges, const U64 coord);
+};
+
 // These use the new std::function constructs
-void part1(const std::vector<std::string> &input);
-void part2(const std::vector<std::string> &input);
+std::size_t part1(const std::vector<std::string_view> &input);
+std::size_t part2(const std::vector<std::string_view> &input);
 // These use the new template/concept stuff (w/ lambda)
-void part1_V2(const std::vector<std::string> &input);
-void part2_V2(const std::vector<std::string> &input);
+std::size_t part1_V2(const std::vector<std::string_view> &input);
+std::size_t part2_V2(const std::vector<std::string_view> &input);
 // These use the new template/concept stuff (w/ visitor)
-void part1_V3(const std::vector<std::string> &input);
-void part2_V3(const std::vector<std::string> &input);
+std::size_t part1_V3(const std::vector<std::string_view> &input);
+std::size_t part2_V3(const std::vector<std::string_view> &input);
 // These use simple C++
-void part1_V4(const std::vector<std::string> &input);
-void part2_V4(const std::vector<std::string> &input);
+std::size_t part1_V4(const std::vector<std::string_view> &input);
+std::size_t part2_V4(const std::vector<std::string_view> &input);
+// These use packed rows with word/SIMD-level range operations
+std::size_t part1_V5(const std::vector<std::string_view> &input);
+std::size_t part2_V5(const std::vector<std::string_view> &input);
+// These use the template/concept lambdas on row bands across threads
+std::size_t part1_V7(const std::vector<std::string_view> &input);
+std::size_t part2_V7(const std::vector<std::string_view> &input);
+std::size_t countParallel(const std::vector<LightInstruction> &instructions, const std::size_t workers);
+std::size_t brightnessParallel(const std::vector<LightInstruction> &instructions, const std::size_t workers);
+// These use coordinate compression (grid size independent)
+std::size_t part1_V6(const std::vector<std::string_view> &input);
+std::size_t part2_V6(const std::vector<std::string_view> &input);
+U64 countCompressed(const std::vector<LightInstruction> &instructions);
+U64 brightnessCompressed(const std::vector<LightInstruction> &instructions);
+
+// Random instructions over an 'extent' x 'extent' grid, for scaling runs beyond the puzzle input
+[[maybe_unused]] std::vector<LightInstruction> generateInstructions(const std::size_t count, const U32 extent, const U32 seed);
+
+[[maybe_unused]] void printInstruction(const LightInstruction instruction);
+std::array<U32, 2> parseCoordinates(const std::string_view str);
+std::vector<LightInstruction> parseInput(const std::vector<std::string_view> &input);
+
+const aoc::Registrar registrar({
+  "day6",
+  "input/day6.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V4(file.lines()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V4(file.lines()); }
+});
+
+const aoc::bench::Registrar variants({
+  {"day6", "part1_std_function", [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.lines()); }},
+  {"day6", "part2_std_function", [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.lines()); }},
+  {"day6", "part1_V2", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V2(file.lines()); }},
+  {"day6", "part2_V2", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V2(file.lines()); }},
+  {"day6", "part1_V3", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V3(file.lines()); }},
+  {"day6", "part2_V3", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V3(file.lines()); }},
+  {"day6", "part1_V5", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V5(file.lines()); }},
+  {"day6", "part2_V5", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V5(file.lines()); }},
+  {"day6", "part1_V6", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V6(file.lines()); }},
+  {"day6", "part2_V6", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V6(file.lines()); }},
+  {"day6", "part1_V7", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_V7(file.lines()); }},
+  {"day6", "part2_V7", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_V7(file.lines()); }}
+});
 
-void printInstruction(const LightInstruction instruction);
-std::array<U16, 2> parseCoordinates(const std::string_view str);
-std::vector<LightInstruction> parseInput(const std::vector<std::string> &input);
+}
 
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<std::string> input = aoc::getMultiLineInput("input/day6.dat");
+  const aoc::MappedInput file("input/day6.dat");
+  const std::vector<std::string_view> input = file.lines();
 
   // Running day6 solutions using std::function
+  aoc::PerfScope perf1;
   const auto start1 = std::chrono::high_resolution_clock::now();
-  part1(input);
-  part2(input);
+  std::cout << "(Part 1) There are " << part1(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2) Total brightness of lit lights is " << part2(input) << std::endl;
   const auto end1 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters1 = perf1.stop();
 
   // Running day6 solutions using templates and concepts (w/ lambda)
+  aoc::PerfScope perf2;
   const auto start2 = std::chrono::high_resolution_clock::now();
-  part1_V2(input);
-  part2_V2(input);
+  std::cout << "(Part 1 V2) There are " << part1_V2(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V2) Total brightness of lit lights is " << part2_V2(input) << std::endl;
   const auto end2 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters2 = perf2.stop();
 
   // Running day6 solutions using templates and concepts (w/ visitor)
+  aoc::PerfScope perf3;
   const auto start3 = std::chrono::high_resolution_clock::now();
-  part1_V3(input);
-  part2_V3(input);
+  std::cout << "(Part 1 V3) There are " << part1_V3(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V3) Total brightness of lit lights is " << part2_V3(input) << std::endl;
   const auto end3 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters3 = perf3.stop();
 
   // Running day6 solutions using basic C++
+  aoc::PerfScope perf4;
   const auto start4 = std::chrono::high_resolution_clock::now();
-  part1_V4(input);
-  part2_V4(input);
+  std::cout << "(Part 1 V4) There are " << part1_V4(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V4) Total brightness of lit lights is " << part2_V4(input) << std::endl;
   const auto end4 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters4 = perf4.stop();
+
+  // Running day6 solutions using packed rows and word-level range operations
+  aoc::PerfScope perf5;
+  const auto start5 = std::chrono::high_resolution_clock::now();
+  std::cout << "(Part 1 V5) There are " << part1_V5(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V5) Total brightness of lit lights is " << part2_V5(input) << std::endl;
+  const auto end5 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters5 = perf5.stop();
+
+  // Running day6 solutions using coordinate compression
+  aoc::PerfScope perf6;
+  const auto start6 = std::chrono::high_resolution_clock::now();
+  std::cout << "(Part 1 V6) There are " << part1_V6(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V6) Total brightness of lit lights is " << part2_V6(input) << std::endl;
+  const auto end6 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters6 = perf6.stop();
+
+  // Running day6 solutions using row bands on worker threads
+  aoc::PerfScope perf7;
+  const auto start7 = std::chrono::high_resolution_clock::now();
+  std::cout << "(Part 1 V7) There are " << part1_V7(input) << " lights that are lit." << std::endl;
+  std::cout << "(Part 2 V7) Total brightness of lit lights is " << part2_V7(input) << std::endl;
+  const auto end7 = std::chrono::high_resolution_clock::now();
+  const aoc::PerfScope::Report counters7 = perf7.stop();
 
   const std::chrono::duration<F32, std::milli> elapsed1 = end1 - start1;
   const std::chrono::duration<F32, std::milli> elapsed2 = end2 - start2;
   const std::chrono::duration<F32, std::milli> elapsed3 = end3 - start3;
   const std::chrono::duration<F32, std::milli> elapsed4 = end4 - start4;
-
-  std::cout << "Elapsed time (using std::function):\t\t\t" << elapsed1.count() << " ms" << std::endl;
-  std::cout << "Elapsed time (using template/concepts w/ lambda):\t" << elapsed2.count() << " ms" << std::endl;
-  std::cout << "Elapsed time (using template/concepts w/ visitor):\t" << elapsed3.count() << " ms" << std::endl;
-  std::cout << "Elapsed time (using simple C++):\t\t\t" << elapsed4.count() << " ms" << std::endl;
+  const std::chrono::duration<F32, std::milli> elapsed5 = end5 - start5;
+  const std::chrono::duration<F32, std::milli> elapsed6 = end6 - start6;
+  const std::chrono::duration<F32, std::milli> elapsed7 = end7 - start7;
+
+  std::cout << "Elapsed time (using std::function):\t\t\t" << elapsed1.count() << " ms\t" << counters1 << std::endl;
+  std::cout << "Elapsed time (using template/concepts w/ lambda):\t" << elapsed2.count() << " ms\t" << counters2 << std::endl;
+  std::cout << "Elapsed time (using template/concepts w/ visitor):\t" << elapsed3.count() << " ms\t" << counters3 << std::endl;
+  std::cout << "Elapsed time (using simple C++):\t\t\t" << elapsed4.count() << " ms\t" << counters4 << std::endl;
+  std::cout << "Elapsed time (using packed word ranges):\t\t" << elapsed5.count() << " ms\t" << counters5 << std::endl;
+  std::cout << "Elapsed time (using coordinate compression):\t\t" << elapsed6.count() << " ms\t" << counters6 << std::endl;
+  std::cout << "Elapsed time (using " << aoc::threadCount() << " row bands):\t\t\t" << elapsed7.count() << " ms\t" << counters7 << std::endl;
+
+  // Scaled-up run on a 10^6 x 10^6 grid, only the compressed engine can hold it.
+  // Example: `SYNTHETIC=500 make day6`
+  if (const char *synthetic = std::getenv("SYNTHETIC")) {
+    const std::size_t count = aoc::parse<std::size_t>(std::string_view(synthetic)).value;
+    const std::vector<LightInstruction> instructions = generateInstructions(count, 1'000'000, 2015);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    std::cout << "(Synthetic " << count << " instructions) There are " << countCompressed(instructions) << " lights that are lit." << std::endl;
+    std::cout << "(Synthetic " << count << " instructions) Total brightness of lit lights is " << brightnessCompressed(instructions) << std::endl;
+    const std::chrono::duration<F32, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Elapsed time (synthetic, coordinate compression):\t" << elapsed.count() << " ms" << std::endl;
+
+    // Same instruction count on the puzzle sized grid, one band vs one band per thread
+    const std::vector<LightInstruction> dense = generateInstructions(count, 1000, 2015);
+    for (const std::size_t workers : {std::size_t{1}, aoc::threadCount()}) {
+      const auto start_dense = std::chrono::high_resolution_clock::now();
+      const std::size_t lit = countParallel(dense, workers);
+      const std::size_t brightness = brightnessParallel(dense, workers);
+      const std::chrono::duration<F32, std::milli> elapsed_dense = std::chrono::high_resolution_clock::now() - start_dense;
+      std::cout << "(Synthetic 1000x1000, " << workers << " bands) " << lit << " lit, brightness " << brightness << "\t" << elapsed_dense.count() << " ms" << std::endl;
+    }
+  }
 
   return 0;
 }
+#endif
+
+namespace {
 
 void printInstruction(const LightInstruction instruction) {
   std::cout
@@ -155,17 +316,15 @@ void printInstruction(const LightInstruction instruction) {
   << std::endl;
 }
 
-std::array<U16, 2> parseCoordinates(const std::string_view str) {
-  const std::size_t comma_loc = str.find(',');
-  const std::string_view n1 = str.substr(0, comma_loc);
-  const std::string_view n2 = str.substr(comma_loc + 1);
-  return {
-    static_cast<U16>(std::strtoul(n1.data(), nullptr, 10)),
-    static_cast<U16>(std::strtoul(n2.data(), nullptr, 10))
-  };
+std::array<U32, 2> parseCoordinates(const std::string_view str) {
+  const char *end = str.data() + str.size();
+  const aoc::ParseResult<U32> x = aoc::parse<U32>(str.data(), end);
+  const aoc::ParseResult<U32> y = aoc::parse<U32>(x.end + 1, end); // Skip the ','
+  RUNTIME_ASSERT_MSG(x && y, str);
+  return {x.value, y.value};
 }
 
-std::vector<LightInstruction> parseInput(const std::vector<std::string> &input) {
+std::vector<LightInstruction> parseInput(const std::vector<std::string_view> &input) {
   constexpr std::array<std::string_view, 4> keywords = {"toggle", "turn on", "turn off", "through"};
   constexpr std::string_view digits = "0123456789";
 
@@ -326,7 +485,301 @@ requires TotalOpsConsumerRowPtr<ROW, ON_OP, OFF_OP, TOGGLE_OP> {
   }
 }
 
-void part1(const std::vector<std::string> &input) {
+template <typename ROW, typename ON_OP, typename OFF_OP, typename TOGGLE_OP>
+void OpsV2<ROW, ON_OP, OFF_OP, TOGGLE_OP>::applyLambdaRows(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights, const std::size_t first_row, const std::size_t last_row) const
+requires TotalOpsConsumerRowRef<ROW, ON_OP, OFF_OP, TOGGLE_OP> {
+  const auto forEachLight = [&](const LightInstruction &instruction, const auto &op) {
+    const std::size_t first_y = std::max<std::size_t>(instruction.coord1[1], first_row);
+    const std::size_t last_y = std::min<std::size_t>(instruction.coord2[1] + 1, last_row);
+    for (std::size_t y = first_y; y < last_y; ++y) {
+      ROW &row = lights[y];
+      for (U16 x = instruction.coord1[0]; x <= instruction.coord2[0]; ++x) {
+        op(row, x);
+      }
+    }
+  };
+
+  for (const LightInstruction &instruction : instructions) {
+    // Command is resolved once per instruction, the lambda is inlined into its loop
+    switch(instruction.cmd) {
+      case Cmd::OFF: {
+        forEachLight(instruction, off_op);
+        break;
+      }
+      case Cmd::ON: {
+        forEachLight(instruction, on_op);
+        break;
+      }
+      case Cmd::TOGGLE: {
+        forEachLight(instruction, toggle_op);
+        break;
+      }
+      default: {
+        std::cerr << "Need to implement support for cmd: " << instruction.toStringCmd() << std::endl;
+        std::exit(1);
+      }
+    };
+  }
+}
+
+template <typename ROW, typename ON_OP, typename OFF_OP, typename TOGGLE_OP>
+template <typename REDUCE>
+std::size_t OpsV2<ROW, ON_OP, OFF_OP, TOGGLE_OP>::applyParallel(const std::vector<LightInstruction> &instructions, std::vector<ROW> &lights, const REDUCE &reduce, const std::size_t workers) const
+requires TotalOpsConsumerRowRef<ROW, ON_OP, OFF_OP, TOGGLE_OP> {
+  const std::size_t bands = std::clamp<std::size_t>(workers, 1, lights.size());
+  std::vector<std::size_t> totals(bands, 0);
+
+  aoc::runWorkers(bands, [&](const std::size_t band) {
+    const std::size_t first_row = band * lights.size() / bands;
+    const std::size_t last_row = (band + 1) * lights.size() / bands;
+    applyLambdaRows(instructions, lights, first_row, last_row);
+
+    std::size_t total = 0;
+    for (std::size_t y = first_row; y < last_row; ++y) {
+      total += reduce(lights[y]);
+    }
+    totals[band] = total;
+  });
+
+  return std::accumulate(totals.begin(), totals.end(), std::size_t{0});
+}
+
+// Whole-word fills/flips for the middle of a span
+void fillWords(U64 *words, const std::size_t count, const U64 value) {
+  std::fill_n(words, count, value);
+}
+
+#ifdef AOC_X86
+AOC_TARGET("avx2") void flipWordsAvx2(U64 *words, const std::size_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i *chunk = reinterpret_cast<__m256i*>(words + i);
+    _mm256_storeu_si256(chunk, _mm256_xor_si256(_mm256_loadu_si256(chunk), ones));
+  }
+  for (; i < count; ++i) {
+    words[i] = ~words[i];
+  }
+}
+
+AOC_TARGET("avx2") void fillWordsAvx2(U64 *words, const std::size_t count, const U64 value) {
+  const __m256i fill = _mm256_set1_epi64x(static_cast<I64>(value));
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(words + i), fill);
+  }
+  for (; i < count; ++i) {
+    words[i] = value;
+  }
+}
+#endif
+
+void flipWords(U64 *words, const std::size_t count) {
+#ifdef AOC_X86
+  if (aoc::cpu::hasAvx2()) {
+    return flipWordsAvx2(words, count);
+  }
+#endif
+  for (std::size_t i = 0; i < count; ++i) {
+    words[i] = ~words[i];
+  }
+}
+
+// Saturating add/subtract and sum over a span of U16 brightness values
+void addSpanScalar(U16 *values, const std::size_t count, const U16 amount) {
+  for (std::size_t i = 0; i < count; ++i) {
+    values[i] = (values[i] > 0xFFFF - amount ? 0xFFFF : values[i] + amount);
+  }
+}
+
+void subSpanScalar(U16 *values, const std::size_t count, const U16 amount) {
+  for (std::size_t i = 0; i < count; ++i) {
+    values[i] = (values[i] < amount ? 0 : values[i] - amount);
+  }
+}
+
+U64 sumSpanScalar(const U16 *values, const std::size_t count) {
+  U64 total = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    total += values[i];
+  }
+  return total;
+}
+
+#ifdef AOC_X86
+AOC_TARGET("avx2") void addSpanAvx2(U16 *values, const std::size_t count, const U16 amount) {
+  const __m256i step = _mm256_set1_epi16(static_cast<I16>(amount));
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256i *chunk = reinterpret_cast<__m256i*>(values + i);
+    _mm256_storeu_si256(chunk, _mm256_adds_epu16(_mm256_loadu_si256(chunk), step));
+  }
+  addSpanScalar(values + i, count - i, amount);
+}
+
+AOC_TARGET("avx2") void subSpanAvx2(U16 *values, const std::size_t count, const U16 amount) {
+  const __m256i step = _mm256_set1_epi16(static_cast<I16>(amount));
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256i *chunk = reinterpret_cast<__m256i*>(values + i);
+    _mm256_storeu_si256(chunk, _mm256_subs_epu16(_mm256_loadu_si256(chunk), step));
+  }
+  subSpanScalar(values + i, count - i, amount);
+}
+
+// Sums the low and high bytes separately with SAD into 64-bit lanes, so nothing can overflow
+AOC_TARGET("avx2") U64 sumSpanAvx2(const U16 *values, const std::size_t count) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i low_bytes = _mm256_set1_epi16(0x00FF);
+  __m256i low = zero;
+  __m256i high = zero;
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    low = _mm256_add_epi64(low, _mm256_sad_epu8(_mm256_and_si256(chunk, low_bytes), zero));
+    high = _mm256_add_epi64(high, _mm256_sad_epu8(_mm256_srli_epi16(chunk, 8), zero));
+  }
+  const __m256i lanes = _mm256_add_epi64(low, _mm256_slli_epi64(high, 8));
+  const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+  const U64 total = static_cast<U64>(_mm_cvtsi128_si64(half)) + static_cast<U64>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half)));
+  return total + sumSpanScalar(values + i, count - i);
+}
+
+// SSE2 is always there on x86-64
+void addSpanSse2(U16 *values, const std::size_t count, const U16 amount) {
+  const __m128i step = _mm_set1_epi16(static_cast<I16>(amount));
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i *chunk = reinterpret_cast<__m128i*>(values + i);
+    _mm_storeu_si128(chunk, _mm_adds_epu16(_mm_loadu_si128(chunk), step));
+  }
+  addSpanScalar(values + i, count - i, amount);
+}
+
+void subSpanSse2(U16 *values, const std::size_t count, const U16 amount) {
+  const __m128i step = _mm_set1_epi16(static_cast<I16>(amount));
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i *chunk = reinterpret_cast<__m128i*>(values + i);
+    _mm_storeu_si128(chunk, _mm_subs_epu16(_mm_loadu_si128(chunk), step));
+  }
+  subSpanScalar(values + i, count - i, amount);
+}
+
+U64 sumSpanSse2(const U16 *values, const std::size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+  __m128i low = zero;
+  __m128i high = zero;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    low = _mm_add_epi64(low, _mm_sad_epu8(_mm_and_si128(chunk, low_bytes), zero));
+    high = _mm_add_epi64(high, _mm_sad_epu8(_mm_srli_epi16(chunk, 8), zero));
+  }
+  const __m128i lanes = _mm_add_epi64(low, _mm_slli_epi64(high, 8));
+  const U64 total = static_cast<U64>(_mm_cvtsi128_si64(lanes)) + static_cast<U64>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(lanes, lanes)));
+  return total + sumSpanScalar(values + i, count - i);
+}
+#endif
+
+void addSpan(U16 *values, const std::size_t count, const U16 amount) {
+#ifdef AOC_X86
+  if (aoc::cpu::hasAvx2()) {
+    return addSpanAvx2(values, count, amount);
+  }
+  return addSpanSse2(values, count, amount);
+#else
+  addSpanScalar(values, count, amount);
+#endif
+}
+
+void subSpan(U16 *values, const std::size_t count, const U16 amount) {
+#ifdef AOC_X86
+  if (aoc::cpu::hasAvx2()) {
+    return subSpanAvx2(values, count, amount);
+  }
+  return subSpanSse2(values, count, amount);
+#else
+  subSpanScalar(values, count, amount);
+#endif
+}
+
+U64 sumSpan(const U16 *values, const std::size_t count) {
+#ifdef AOC_X86
+  if (aoc::cpu::hasAvx2()) {
+    return sumSpanAvx2(values, count);
+  }
+  return sumSpanSse2(values, count);
+#else
+  return sumSpanScalar(values, count);
+#endif
+}
+
+template <U16 COLUMNS>
+template <Cmd CMD>
+void LightGrid<COLUMNS>::applyRange(const U16 row, const U16 first, const U16 last) {
+  U64 *words = rows[row].data();
+  const U16 first_word = first / 64;
+  const U16 last_word = last / 64;
+  const U64 first_mask = ~0ULL << (first % 64);
+  const U64 last_mask = ~0ULL >> (63 - last % 64);
+
+  const auto apply = [](U64 &word, const U64 mask) {
+    if constexpr (CMD == Cmd::ON) { word |= mask; }
+    else if constexpr (CMD == Cmd::OFF) { word &= ~mask; }
+    else { word ^= mask; }
+  };
+
+  if (first_word == last_word) {
+    apply(words[first_word], first_mask & last_mask);
+    return;
+  }
+  apply(words[first_word], first_mask);
+  apply(words[last_word], last_mask);
+
+  U64 *middle = words + first_word + 1;
+  const std::size_t count = last_word - first_word - 1;
+  if constexpr (CMD == Cmd::TOGGLE) {
+    flipWords(middle, count);
+  } else {
+    const U64 value = (CMD == Cmd::ON ? ~0ULL : 0ULL);
+#ifdef AOC_X86
+    if (aoc::cpu::hasAvx2()) {
+      return fillWordsAvx2(middle, count, value);
+    }
+#endif
+    fillWords(middle, count, value);
+  }
+}
+
+template <U16 COLUMNS>
+void LightGrid<COLUMNS>::setRange(const U16 row, const U16 first, const U16 last) {
+  applyRange<Cmd::ON>(row, first, last);
+}
+
+template <U16 COLUMNS>
+void LightGrid<COLUMNS>::resetRange(const U16 row, const U16 first, const U16 last) {
+  applyRange<Cmd::OFF>(row, first, last);
+}
+
+template <U16 COLUMNS>
+void LightGrid<COLUMNS>::flipRange(const U16 row, const U16 first, const U16 last) {
+  applyRange<Cmd::TOGGLE>(row, first, last);
+}
+
+template <U16 COLUMNS>
+std::size_t LightGrid<COLUMNS>::count() const {
+  std::size_t total = 0;
+  for (const ROW &row : rows) {
+    for (const U64 word : row) {
+      total += std::popcount(word);
+    }
+  }
+  return total;
+}
+
+std::size_t part1(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::bitset<num_columns>;
@@ -345,10 +798,10 @@ void part1(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + row.count(); };
   const std::size_t count = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 1) There are " << count << " lights that are lit." << std::endl;
+  return count;
 }
 
-void part2(const std::vector<std::string> &input) {
+std::size_t part2(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::array<U16, num_columns>;
@@ -367,10 +820,10 @@ void part2(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + std::accumulate(row.begin(), row.end(), 0); };
   const std::size_t brightness = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 2) Total brightness of lit lights is " << brightness << std::endl;
+  return brightness;
 }
 
-void part1_V2(const std::vector<std::string> &input) {
+std::size_t part1_V2(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::bitset<num_columns>;
@@ -388,10 +841,10 @@ void part1_V2(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + row.count(); };
   const std::size_t count = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 1 V2) There are " << count << " lights that are lit." << std::endl;
+  return count;
 }
 
-void part2_V2(const std::vector<std::string> &input) {
+std::size_t part2_V2(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::array<U16, num_columns>;
@@ -409,10 +862,10 @@ void part2_V2(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + std::accumulate(row.begin(), row.end(), 0); };
   const std::size_t brightness = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 2 V2) Total brightness of lit lights is " << brightness << std::endl;
+  return brightness;
 }
 
-void part1_V3(const std::vector<std::string> &input) {
+std::size_t part1_V3(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::bitset<num_columns>;
@@ -430,10 +883,10 @@ void part1_V3(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + row.count(); };
   const std::size_t count = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 1 V3) There are " << count << " lights that are lit." << std::endl;
+  return count;
 }
 
-void part2_V3(const std::vector<std::string> &input) {
+std::size_t part2_V3(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::array<U16, num_columns>;
@@ -451,10 +904,10 @@ void part2_V3(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + std::accumulate(row.begin(), row.end(), 0); };
   const std::size_t brightness = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 2 V3) Total brightness of lit lights is " << brightness << std::endl;
+  return brightness;
 }
 
-void part1_V4(const std::vector<std::string> &input) {
+std::size_t part1_V4(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::bitset<num_columns>;
@@ -493,10 +946,10 @@ void part1_V4(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + row.count(); };
   const std::size_t count = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 1 V4) There are " << count << " lights that are lit." << std::endl;
+  return count;
 }
 
-void part2_V4(const std::vector<std::string> &input) {
+std::size_t part2_V4(const std::vector<std::string_view> &input) {
   // Settings some configurations
   constexpr U16 num_columns = 1000;
   using ROW = std::array<U16, num_columns>;
@@ -536,5 +989,248 @@ void part2_V4(const std::vector<std::string> &input) {
 
   const auto sumRow = [](std::size_t total, const ROW &row) -> std::size_t { return total + std::accumulate(row.begin(), row.end(), 0); };
   const std::size_t brightness = std::accumulate(lights.begin(), lights.end(), 0L, sumRow);
-  std::cout << "(Part 2 V4) Total brightness of lit lights is " << brightness << std::endl;
+  return brightness;
+}
+
+std::size_t part1_V5(const std::vector<std::string_view> &input) {
+  // Settings some configurations
+  constexpr U16 num_columns = 1000;
+
+  const std::vector<LightInstruction> instructions = parseInput(input);
+  LightGrid<num_columns> lights(num_columns); // initializes 1000 rows of columns with bit value '0'
+
+  for (const LightInstruction instruction : instructions) {
+    const U16 first = instruction.coord1[0];
+    const U16 last = instruction.coord2[0];
+    // Command is resolved once per instruction rather than once per light
+    switch(instruction.cmd) {
+      case Cmd::OFF: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          lights.resetRange(y, first, last);
+        }
+        break;
+      }
+      case Cmd::ON: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          lights.setRange(y, first, last);
+        }
+        break;
+      }
+      case Cmd::TOGGLE: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          lights.flipRange(y, first, last);
+        }
+        break;
+      }
+      default: {
+        std::cerr << "Need to implement support for cmd: " << instruction.toStringCmd() << std::endl;
+        std::exit(1);
+      }
+    };
+  }
+
+  return lights.count();
+}
+
+std::size_t part2_V5(const std::vector<std::string_view> &input) {
+  // Settings some configurations
+  constexpr U16 num_columns = 1000;
+  using ROW = std::array<U16, num_columns>;
+
+  const std::vector<LightInstruction> instructions = parseInput(input);
+  std::vector<ROW> lights;
+  lights.resize(num_columns); // initializes 1000 rows of columns with integral value '0'
+
+  for (const LightInstruction instruction : instructions) {
+    const U16 first = instruction.coord1[0];
+    const std::size_t width = instruction.coord2[0] - first + 1;
+    // Command is resolved once per instruction, each row is one saturating SIMD span
+    switch(instruction.cmd) {
+      case Cmd::OFF: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          subSpan(lights[y].data() + first, width, 1);
+        }
+        break;
+      }
+      case Cmd::ON: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          addSpan(lights[y].data() + first, width, 1);
+        }
+        break;
+      }
+      case Cmd::TOGGLE: {
+        for (U16 y = instruction.coord1[1]; y <= instruction.coord2[1]; ++y) {
+          addSpan(lights[y].data() + first, width, 2);
+        }
+        break;
+      }
+      default: {
+        std::cerr << "Need to implement support for cmd: " << instruction.toStringCmd() << std::endl;
+        std::exit(1);
+      }
+    };
+  }
+
+  // Rows are contiguous, so the whole grid is summed as one span
+  return sumSpan(lights.front().data(), lights.size() * num_columns);
+}
+
+CompressedGrid::CompressedGrid(const std::vector<LightInstruction> &instructions) {
+  xs.reserve(2 * instructions.size());
+  ys.reserve(2 * instructions.size());
+  // Inclusive rectangles, so the closing edge is one past the last light
+  for (const LightInstruction &instruction : instructions) {
+    xs.push_back(instruction.coord1[0]);
+    xs.push_back(static_cast<U64>(instruction.coord2[0]) + 1);
+    ys.push_back(instruction.coord1[1]);
+    ys.push_back(static_cast<U64>(instruction.coord2[1]) + 1);
+  }
+  for (std::vector<U64> *edges : {&xs, &ys}) {
+    std::sort(edges->begin(), edges->end());
+    edges->erase(std::unique(edges->begin(), edges->end()), edges->end());
+  }
+}
+
+std::size_t CompressedGrid::cellIndex(const std::vector<U64> &edges, const U64 coord) {
+  return std::lower_bound(edges.begin(), edges.end(), coord) - edges.begin();
+}
+
+template <typename CELL, typename ON_OP, typename OFF_OP, typename TOGGLE_OP>
+U64 CompressedGrid::apply(const std::vector<LightInstruction> &instructions, const ON_OP &on_op, const OFF_OP &off_op, const TOGGLE_OP &toggle_op) const {
+  if (xs.empty()) {
+    return 0;
+  }
+  const std::size_t columns = xs.size() - 1;
+  const std::size_t rows = ys.size() - 1;
+  std::vector<CELL> cells(rows * columns);
+
+  for (const LightInstruction &instruction : instructions) {
+    const std::size_t x_first = cellIndex(xs, instruction.coord1[0]);
+    const std::size_t x_last = cellIndex(xs, static_cast<U64>(instruction.coord2[0]) + 1);
+    const std::size_t y_first = cellIndex(ys, instruction.coord1[1]);
+    const std::size_t y_last = cellIndex(ys, static_cast<U64>(instruction.coord2[1]) + 1);
+
+    const auto forEachCell = [&](const auto &op) {
+      for (std::size_t y = y_first; y < y_last; ++y) {
+        CELL *row = cells.data() + y * columns;
+        for (std::size_t x = x_first; x < x_last; ++x) {
+          op(row[x]);
+        }
+      }
+    };
+
+    switch(instruction.cmd) {
+      case Cmd::OFF: {
+        forEachCell(off_op);
+        break;
+      }
+      case Cmd::ON: {
+        forEachCell(on_op);
+        break;
+      }
+      case Cmd::TOGGLE: {
+        forEachCell(toggle_op);
+        break;
+      }
+      default: {
+        std::cerr << "Need to implement support for cmd: " << instruction.toStringCmd() << std::endl;
+        std::exit(1);
+      }
+    };
+  }
+
+  // Each cell stands for (width * height) lights of the original grid
+  U64 total = 0;
+  for (std::size_t y = 0; y < rows; ++y) {
+    const U64 height = ys[y + 1] - ys[y];
+    U64 row_total = 0;
+    for (std::size_t x = 0; x < columns; ++x) {
+      row_total += static_cast<U64>(cells[y * columns + x]) * (xs[x + 1] - xs[x]);
+    }
+    total += row_total * height;
+  }
+  return total;
+}
+
+U64 countCompressed(const std::vector<LightInstruction> &instructions) {
+  const CompressedGrid grid(instructions);
+  return grid.apply<U8>(instructions,
+    [](U8 &cell) { cell = 1; },
+    [](U8 &cell) { cell = 0; },
+    [](U8 &cell) { cell ^= 1; });
+}
+
+U64 brightnessCompressed(const std::vector<LightInstruction> &instructions) {
+  const CompressedGrid grid(instructions);
+  return grid.apply<U32>(instructions,
+    [](U32 &cell) { cell += 1; },
+    [](U32 &cell) { cell = (cell == 0 ? 0 : cell - 1); },
+    [](U32 &cell) { cell += 2; });
+}
+
+std::size_t countParallel(const std::vector<LightInstruction> &instructions, const std::size_t workers) {
+  // Settings some configurations
+  constexpr U16 num_columns = 1000;
+  using ROW = std::bitset<num_columns>;
+
+  std::vector<ROW> lights;
+  lights.resize(num_columns); // initializes 1000 rows of columns with bit value '0'
+
+  const auto on_op = [](ROW &row, const U16 column) { row.set(column); };
+  const auto off_op = [](ROW &row, const U16 column) { row.reset(column); };
+  const auto toggle_op = [](ROW &row, const U16 column) { row.flip(column); };
+  const OpsV2<ROW, decltype(on_op), decltype(off_op), decltype(toggle_op)> ops = {on_op, off_op, toggle_op};
+
+  return ops.applyParallel(instructions, lights, [](const ROW &row) -> std::size_t { return row.count(); }, workers);
+}
+
+std::size_t brightnessParallel(const std::vector<LightInstruction> &instructions, const std::size_t workers) {
+  // Settings some configurations
+  constexpr U16 num_columns = 1000;
+  using ROW = std::array<U16, num_columns>;
+
+  std::vector<ROW> lights;
+  lights.resize(num_columns); // initializes 1000 rows of columns with integral value '0'
+
+  const auto on_op = [](ROW &row, const U16 column) { row[column] += 1; };
+  const auto off_op = [](ROW &row, const U16 column) { row[column] = (row[column] == 0 ? 0 : row[column] - 1); };
+  const auto toggle_op = [](ROW &row, const U16 column) { row[column] += 2; };
+  const OpsV2<ROW, decltype(on_op), decltype(off_op), decltype(toggle_op)> ops = {on_op, off_op, toggle_op};
+
+  return ops.applyParallel(instructions, lights, [](const ROW &row) -> std::size_t { return sumSpan(row.data(), row.size()); }, workers);
+}
+
+std::size_t part1_V7(const std::vector<std::string_view> &input) {
+  return countParallel(parseInput(input), aoc::threadCount());
+}
+
+std::size_t part2_V7(const std::vector<std::string_view> &input) {
+  return brightnessParallel(parseInput(input), aoc::threadCount());
+}
+
+std::size_t part1_V6(const std::vector<std::string_view> &input) {
+  return countCompressed(parseInput(input));
+}
+
+std::size_t part2_V6(const std::vector<std::string_view> &input) {
+  return brightnessCompressed(parseInput(input));
+}
+
+std::vector<LightInstruction> generateInstructions(const std::size_t count, const U32 extent, const U32 seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<U32> coord(0, extent - 1);
+  std::uniform_int_distribution<int> cmd(0, 2);
+
+  std::vector<LightInstruction> instructions;
+  instructions.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const U32 x1 = coord(rng), x2 = coord(rng);
+    const U32 y1 = coord(rng), y2 = coord(rng);
+    instructions.emplace_back(static_cast<Cmd>(cmd(rng)),
+                              std::array<U32, 2>{std::min(x1, x2), std::min(y1, y2)},
+                              std::array<U32, 2>{std::max(x1, x2), std::max(y1, y2)});
+  }
+  return instructions;
+}
+
 }
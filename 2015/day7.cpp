@@ -2,28 +2,34 @@
 #include <array>
 #include <bitset>
 #include <cerrno>
+#include <chrono>
 #include <iostream>
 #include <type_traits>
 #include <numeric>
+#include <random>
+#include <queue>
 #include <ranges>
+#include <span>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <variant>
 #include <vector>
 #include <utility>
-#include <unordered_map>
 
 #include <libs/util.hpp>
 
+namespace {
+
 /////////////////////////////////////////////////////////////
 // Set up a blueprint containing requirements and constraints
 /////////////////////////////////////////////////////////////
 
 template <typename WIRE>
-concept WireConcept = requires(WIRE &wire) {
-  { wire.set } -> std::same_as<bool&>;
-  { wire.signal } -> std::same_as<U16&>;
-  { wire.label  } -> std::same_as<const std::string&>;
+concept WireConcept = requires(const WIRE &wire) {
+  { wire.set } -> std::convertible_to<bool>;
+  { wire.signal } -> std::convertible_to<U16>;
+  { wire.label  } -> std::convertible_to<std::string_view>;
 };
 
 template <typename T>
@@ -58,17 +64,41 @@ concept ShiftFunction = requires(const FUNCTION &func, const INPUT &input, const
 // Build circuit data structures according to the blueprints ...
 ////////////////////////////////////////////////////////////////
 
+// Snapshot of one wire, built from WireSignals when a gate reads it
 struct Wire {
   bool set;
   U16 signal;
-  const std::string label;
+  std::string_view label;
 };
 static_assert(WireConcept<Wire>, "Wire type must satisfy WireConcept");
 
-//using Wires = std::vector<Wire*>; // TODO :: DOES NOT WORK!? // TODO :: ALSO, WIRESCONCEPTS CHECK PASSES SOMEHOW W/O *
-using Wires = std::array<Wire*, 2>;
+using Wires = std::array<Wire, 2>;
 static_assert(WiresConcept<Wires>, "Wires type must satisfy WiresConcept");
 
+// Every wire's signal in one contiguous vector indexed by Interner id, with a parallel
+// bitmap of the wires that are set. Gates refer to wires by id and read them through view().
+class WireSignals {
+public:
+  explicit WireSignals(aoc::Interner interned)
+    : names(std::move(interned)), signal(names.size()), set_bits((names.size() + 63) / 64) {}
+
+  bool isSet(const U32 id) const { return (set_bits[id / 64] >> (id % 64)) & 1; }
+  U16 get(const U32 id) const { return signal[id]; }
+  void assign(const U32 id, const U16 value) {
+    signal[id] = value;
+    set_bits[id / 64] |= U64{1} << (id % 64);
+  }
+
+  Wire view(const U32 id) const { return Wire{isSet(id), signal[id], names.name(id)}; }
+  U32 id(const std::string_view name) const { return *names.find(name); }
+  std::size_t size() const { return signal.size(); }
+
+private:
+  aoc::Interner names;
+  std::vector<U16> signal;
+  std::vector<U64> set_bits;
+};
+
 enum class GateTypes
 {
   AND,
@@ -99,7 +129,7 @@ struct GateFunctions {
         input.cbegin(),
         input.cend(),
         static_cast<U16>(~0), // Note: All bits set to '1' for cumulative AND operation
-        [](const U16 result, const Wire *wire) -> U16 { return result & wire->signal; });
+        [](const U16 result, const Wire &wire) -> U16 { return result & wire.signal; });
   }
   /* // TODO :: Checking if this is even necessary ...
   static constexpr auto AND = [](const WiresConcept auto &input) -> U16 {
@@ -107,7 +137,7 @@ struct GateFunctions {
         input.cbegin(),
         input.cend(),
         static_cast<U16>(~0), // Note: All bits set to '1' for cumulative AND operation
-        [](const U16 result, const Wire *wire) -> U16 { return result & wire->signal; });
+        [](const U16 result, const Wire &wire) -> U16 { return result & wire.signal; });
   };
   */
 
@@ -116,10 +146,7 @@ struct GateFunctions {
         input.cbegin(),
         input.cend(),
         static_cast<U16>(0), // Note: All bits set to '0' for cumulative OR operation
-        [](const U16 result, const Wire *wire) -> U16 {
-          std::cerr << "Is wire null? " << (wire == nullptr ? "YES" : "NO") << std::endl;
-           return result | wire->signal;
-           });
+        [](const U16 result, const Wire &wire) -> U16 { return result | wire.signal; });
   };
 
   static constexpr auto LSHIFT = [](const WireConcept auto &input, const U16 shift) -> U16 {
@@ -145,35 +172,39 @@ struct GateFunctions {
 template <typename FUNCTION, typename INPUT>
 requires SignalFunction<FUNCTION, INPUT> || ShiftFunction<FUNCTION, INPUT>
 struct Gate {
-  const FUNCTION &function;
-  Wire &output;
-  INPUT &input;
+  const FUNCTION function; // By value: the gate constructors pass temporaries
+  U32 output;
+  std::array<U32, 2> input; // Wire ids, the second one only read by Wires inputs
 
-  Gate(const FUNCTION &f, Wire &out, INPUT &in) : function(f), output(out), input(in) {}
+  Gate(const FUNCTION &f, const U32 out, const std::array<U32, 2> in) : function(f), output(out), input(in) {}
 
   virtual std::string_view type() const noexcept = 0;
-  virtual U16 activate() const noexcept = 0;
+  virtual U16 activate(const INPUT &wires) const noexcept = 0;
+
+  INPUT load(const WireSignals &signals) const noexcept {
+    if constexpr (WireConcept<INPUT>) {
+      return signals.view(input[0]);
+    }
+    else {
+      return INPUT{signals.view(input[0]), signals.view(input[1])};
+    }
+  }
 
-  void check_input() const {
+  void check_input(const WireSignals &signals) const {
     std::cerr << "Checking input ... " << std::endl;
-    check_input(type(), input);
+    check_input(type(), load(signals));
   }
 
-  bool try_activate() noexcept {
-    std::cerr << "try_activate() ..." << std::endl;
-    if (output.set) {
-      std::cerr << "Gate " << type() << " already processed." << std::endl;
-      return true; 
+  bool try_activate(WireSignals &signals) noexcept {
+    if (signals.isSet(output)) {
+      return true;
     }
-    else if (is_all_input_set(input)) {
-      std::cerr << "All inputs set for " << type() << " gate." << std::endl;
-      output.signal = activate();
-      return (output.set = true);
-    }
-    else {
-      std::cerr << "Gate " << type() << " is waiting for all inputs to be defined." << std::endl;
-      return false;
+    const INPUT wires = load(signals);
+    if (is_all_input_set(wires)) {
+      signals.assign(output, activate(wires));
+      return true;
     }
+    return false;
   }
 
 private:
@@ -183,30 +214,20 @@ private:
   static void check_input(const std::string_view type, const WiresConcept auto &input) {
     U64 i = 0;
     std::cerr << "About to loop through wires ... " << std::endl;
-    for (const WireConcept auto *wire : input) {
-      if (wire == nullptr) {
-        std::cerr << "Gate: " << type << " w/ wires[" << i++ << "]: NULL" << std::endl;
-      }
-      else {
-        std::cerr << "Gate: " << type << " w/ wires[" << i++ << "]: " << wire->label << std::endl;
-      }
+    for (const WireConcept auto &wire : input) {
+      std::cerr << "Gate: " << type << " w/ wires[" << i++ << "]: " << wire.label << std::endl;
     }
   }
 
   static bool is_all_input_set(const WireConcept auto &input) noexcept {
-    std::cerr << "is_all_input_set(WireConcept)" << std::endl;
     return input.set;
   }
 
   static bool is_all_input_set(const WiresConcept auto &input) noexcept {
-    std::cerr << "is_all_input_set(WiresConcept)" << std::endl;
     return std::all_of(
         input.cbegin(),
         input.cend(),
-        [](const WireConcept auto *wire) -> bool { 
-          if (wire == nullptr) { std::cerr << "Wire is NULL" << std::endl; return false; }
-          return wire->set;
-          });
+        [](const WireConcept auto &wire) -> bool { return wire.set; });
   }
 };
 
@@ -226,66 +247,65 @@ using MultiInputFunction = U16 (*)(const Wires &input);
 using ShiftInputFunction = U16 (*)(const Wire &input, const U16 shift);
 
 struct SingleInputGate : public Gate<SingleInputFunction, Wire> {
-  SingleInputGate(const SingleInputFunction &f, Wire &out, Wire &in) : Gate<SingleInputFunction, Wire>(f, out, in) {}
-  virtual U16 activate() const noexcept override {
-    return function(input);
+  SingleInputGate(const SingleInputFunction &f, const U32 out, const std::array<U32, 2> in) : Gate<SingleInputFunction, Wire>(f, out, in) {}
+  virtual U16 activate(const Wire &wire) const noexcept override {
+    return function(wire);
   }
 };
 
 struct MultiInputGate : public Gate<MultiInputFunction, Wires> {
-  MultiInputGate(const MultiInputFunction &f, Wire &out, Wires &in) : Gate<MultiInputFunction, Wires>(f, out, in) {}
-  virtual U16 activate() const noexcept override {
-    return function(input);
+  MultiInputGate(const MultiInputFunction &f, const U32 out, const std::array<U32, 2> in) : Gate<MultiInputFunction, Wires>(f, out, in) {}
+  virtual U16 activate(const Wires &wires) const noexcept override {
+    return function(wires);
   }
 };
 
 struct ShiftInputGate : public Gate<ShiftInputFunction, Wire> {
   const U16 shift;
-  ShiftInputGate(const ShiftInputFunction &f, const U16 bitshift, Wire &out, Wire &in) : Gate<ShiftInputFunction, Wire>(f, out, in), shift(bitshift) {}
-  virtual U16 activate() const noexcept override {
-    return function(input, shift);
+  ShiftInputGate(const ShiftInputFunction &f, const U16 bitshift, const U32 out, const U32 in) : Gate<ShiftInputFunction, Wire>(f, out, {in, in}), shift(bitshift) {}
+  virtual U16 activate(const Wire &wire) const noexcept override {
+    return function(wire, shift);
   }
 };
 
 
 struct ANDGate : public MultiInputGate {
-  ANDGate(Wire &out, Wires &in) : MultiInputGate(GateFunctions::AND, out, in) {}
+  ANDGate(const U32 out, const std::array<U32, 2> in) : MultiInputGate(GateFunctions::AND, out, in) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::AND);
   }
 };
 
 struct ORGate : public MultiInputGate {
-  ORGate(Wire &out, Wires &in) : MultiInputGate(GateFunctions::OR, out, in) {}
+  ORGate(const U32 out, const std::array<U32, 2> in) : MultiInputGate(GateFunctions::OR, out, in) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::OR);
   }
 };
 
 struct NOTGate : public SingleInputGate {
-  NOTGate(Wire &out, Wire &in) : SingleInputGate(GateFunctions::NOT, out, in) {}
+  NOTGate(const U32 out, const U32 in) : SingleInputGate(GateFunctions::NOT, out, {in, in}) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::NOT);
   }
 };
 
 struct LSHIFTGate : public ShiftInputGate {
-  LSHIFTGate(const U16 shift, Wire &out, Wire &in) : ShiftInputGate(GateFunctions::LSHIFT, shift, out, in) {}
+  LSHIFTGate(const U16 shift, const U32 out, const U32 in) : ShiftInputGate(GateFunctions::LSHIFT, shift, out, in) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::LSHIFT);
   }
 };
 
 struct RSHIFTGate : public ShiftInputGate {
-  const U16 shift;
-  RSHIFTGate(const U16 shift, Wire &out, Wire &in) : ShiftInputGate(GateFunctions::RSHIFT, shift, out, in) {}
+  RSHIFTGate(const U16 shift, const U32 out, const U32 in) : ShiftInputGate(GateFunctions::RSHIFT, shift, out, in) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::RSHIFT);
   }
 };
 
 struct PASSTHROUGHGate : public SingleInputGate {
-  PASSTHROUGHGate(Wire &out, Wire &in) : SingleInputGate(GateFunctions::PASS_THROUGH, out, in) {}
+  PASSTHROUGHGate(const U32 out, const U32 in) : SingleInputGate(GateFunctions::PASS_THROUGH, out, {in, in}) {}
   virtual std::string_view type() const noexcept override {
     return GateFunctions::toString(GateTypes::PASSTHROUGH);
   }
@@ -345,33 +365,855 @@ struct PASSTHROUGHGate : public PASSTHROUGHGateSpecialization {
 };
 */
 
+// Devirtualized gate: the opcode drives a switch that calls GateFunctions directly, so there
+// is no vtable and no function pointer.
+struct SwitchGate {
+  GateTypes opcode;
+  U32 output;
+  std::array<U32, 2> input; // AND/OR read both wires, every other gate only input[0]
+  U16 shift;
+
+  std::string_view type() const noexcept { return GateFunctions::toString(opcode); }
+
+  U16 activate(const WireSignals &signals) const noexcept {
+    switch(opcode) {
+      case GateTypes::AND: return GateFunctions::AND(Wires{signals.view(input[0]), signals.view(input[1])});
+      case GateTypes::OR: return GateFunctions::OR(Wires{signals.view(input[0]), signals.view(input[1])});
+      case GateTypes::NOT: return GateFunctions::NOT(signals.view(input[0]));
+      case GateTypes::LSHIFT: return GateFunctions::LSHIFT(signals.view(input[0]), shift);
+      case GateTypes::RSHIFT: return GateFunctions::RSHIFT(signals.view(input[0]), shift);
+      case GateTypes::PASSTHROUGH: return GateFunctions::PASS_THROUGH(signals.view(input[0]));
+      default: return 0; // GATE_COUNT isn't a valid type!
+    }
+  }
+
+  bool try_activate(WireSignals &signals) noexcept {
+    if (signals.isSet(output)) {
+      return true;
+    }
+    const bool binary = (opcode == GateTypes::AND || opcode == GateTypes::OR);
+    if (signals.isSet(input[0]) && (!binary || signals.isSet(input[1]))) {
+      signals.assign(output, activate(signals));
+      return true;
+    }
+    return false;
+  }
+};
+
+// The switch calls the very same functions the gate hierarchy is checked against
+static_assert(SignalFunction<decltype([](const Wires &input) { return GateFunctions::AND(input); }), Wires>);
+static_assert(SignalFunction<decltype(GateFunctions::OR), Wires>);
+static_assert(SignalFunction<decltype(GateFunctions::NOT), Wire>);
+static_assert(SignalFunction<decltype(GateFunctions::PASS_THROUGH), Wire>);
+static_assert(ShiftFunction<decltype(GateFunctions::LSHIFT), Wire>);
+static_assert(ShiftFunction<decltype(GateFunctions::RSHIFT), Wire>);
+
+using VirtualGate = std::variant<ANDGate, ORGate, NOTGate, LSHIFTGate, RSHIFTGate, PASSTHROUGHGate>;
+
+// Object-per-gate circuit, solved by sweeping every gate until all outputs are set.
+// GATE is either the virtual gate hierarchy (in a variant) or SwitchGate.
+template <typename GATE>
+class GateCircuit {
+public:
+  explicit GateCircuit(const std::vector<std::string_view> &input);
+
+  // Sweeps every gate until all of them are set
+  void settle();
+  // Evaluates every gate once, in input order, whether its inputs are set or not
+  void activateAll();
+
+  U16 signal(const std::string_view name) const { return signals.get(signals.id(name)); }
+  std::size_t gateCount() const { return gates.size(); }
+
+private:
+  WireSignals signals;
+  std::vector<GATE> gates;
+
+  // Every wire name, literal operands included
+  static aoc::Interner internWires(const std::vector<std::string_view> &input);
+  void addGate(const GateTypes type, const U32 out, const U32 a, const U32 b, const U16 shift);
+};
+
+////////////////////////////////////////////////////////////////
+// Compiled circuit: dense wire indices and a flat, topologically
+// sorted instruction tape evaluated in a single pass.
+////////////////////////////////////////////////////////////////
+
+class Circuit {
+public:
+  // Parses and compiles the circuit. Throws std::runtime_error on malformed lines,
+  // wires that are driven twice or never, and cycles.
+  explicit Circuit(const std::vector<std::string_view> &input);
+
+  // Runs the whole tape once
+  void evaluate();
+
+  // Forces a wire to 'value' (its driving gate, if any, is disabled) and marks every
+  // gate reading it dirty. Nothing is recomputed until the next get().
+  void override(const std::string_view name, const U16 value);
+  // Settles the circuit (full pass the first time, otherwise only the dirty cone)
+  U16 get(const std::string_view name);
+
+  std::size_t wireCount() const { return names.size(); }
+  std::size_t gateCount() const { return tape.opcode.size(); }
+  // Gates evaluated by the last settle
+  std::size_t recomputedGates() const { return recomputed; }
+
+  // Batch mode: every wire is a lane array, so LANES independent runs share one tape pass.
+  // 32 x U16 is one AVX-512 register or two AVX2 ones.
+  static constexpr std::size_t LANES = 32;
+  struct alignas(64) Lanes {
+    std::array<U16, LANES> lane;
+  };
+
+  // Runs the circuit once per entry of 'values' assigned to wire 'input' (pinned like
+  // override(), every other source keeps its signal) and stores wire 'output' of each run.
+  void sweep(const std::string_view input, std::span<const U16> values, const std::string_view output, std::span<U16> results);
+
+private:
+  // One entry per gate, in evaluation order
+  struct Tape {
+    std::vector<GateTypes> opcode;
+    std::vector<U32> srcA;
+    std::vector<U32> srcB; // Second input wire, or the shift amount for LSHIFT/RSHIFT
+    std::vector<U32> dst;
+  };
+
+  static constexpr U32 SOURCE = ~0U;      // Constant-driven wires and literal operands
+  static constexpr U32 UNDRIVEN = ~0U - 1;
+
+  aoc::Interner names;
+  std::vector<U32> driver; // Tape position of the gate driving each wire (or SOURCE)
+  std::vector<U16> signals;
+  Tape tape;
+
+  // Incremental state. Consumers are tape positions, so they always come after the
+  // gate that drives the wire and a min-heap yields them in topological order.
+  std::vector<U32> consumer_start; // Per wire, CSR offsets into 'consumers'
+  std::vector<U32> consumers;
+  std::vector<bool> dirty;         // Per tape position
+  std::priority_queue<U32, std::vector<U32>, std::greater<U32>> queue;
+  std::size_t recomputed = 0;
+  bool evaluated = false;
+
+  U32 wireId(const std::string_view token);
+  U32 find(const std::string_view name) const;
+  void drive(const U32 wire, const U32 gate);
+  void pin(const U32 wire);
+  void markConsumers(const U32 wire);
+  void update();
+
+  static U16 apply(const GateTypes opcode, const U16 a, const U32 b, const U16 *signal);
+};
+
 /////////////////////////////////////////////////////////////
 // Implement solution ...
 /////////////////////////////////////////////////////////////
 
-void parseCircuit(const std::vector<std::string> &input);
-std::vector<std::vector<std::string>> tokenize_input(const std::vector<std::string> &input);
+[[maybe_unused]] std::vector<std::vector<std::string>> tokenize_input(const std::vector<std::string_view> &input);
+
+// Compiled tape
+U16 part1(const std::vector<std::string_view> &input);
+// Reference: sweeps every gate until nothing changes (virtual gates, then devirtualized)
+U16 part1_fixed_point(const std::vector<std::string_view> &input);
+U16 part1_switch(const std::vector<std::string_view> &input);
+// Incremental: only the cone downstream of 'b' is recomputed
+U16 part2(const std::vector<std::string_view> &input);
+// Reference: recompiles and evaluates the whole circuit again
+U16 part2_full(const std::vector<std::string_view> &input);
+// Wire 'a' for every possible signal on 'b', summed (one full pass per value vs lane batches)
+U64 sweepScalar(const std::vector<std::string_view> &input);
+U64 sweepLanes(const std::vector<std::string_view> &input);
 
-void part1(const std::vector<std::string> &input);
-void part2(const std::vector<std::string> &input);
+// Random acyclic circuit with 16 constant-driven wires and 'gates' gates named "w<N>"
+[[maybe_unused]] std::vector<std::string> generateCircuit(const std::size_t gates, const U32 seed);
 
+////////////////////////////////////////////////////////////////
+// Compile-time evaluation of a circuit embedded in the binary
+// (`make day7 EMBED=true`). These are constexpr, so unlike the
+// rest of the solution they are defined before main().
+////////////////////////////////////////////////////////////////
+
+constexpr std::size_t splitTokens(const std::string_view line, std::array<std::string_view, 5> &tokens) {
+  std::size_t count = 0;
+  std::size_t pos = line.find_first_not_of(' ');
+  while (pos != std::string_view::npos) {
+    if (count == tokens.size()) {
+      throw std::runtime_error("Malformed circuit line: '" + std::string(line) + "'");
+    }
+    const std::size_t end = std::min(line.find(' ', pos), line.size());
+    tokens[count++] = line.substr(pos, end - pos);
+    pos = line.find_first_not_of(' ', end);
+  }
+  return count;
+}
+
+// Final signal of every wire. Embedded circuits only use puzzle-style names (1-2 lowercase
+// letters), so the table is indexed straight by the interner's perfect hash.
+struct WireTable {
+  std::array<U16, aoc::Interner::SHORT_SLOTS> signal{};
+  std::array<bool, aoc::Interner::SHORT_SLOTS> present{};
+
+  constexpr U16 get(const std::string_view name) const {
+    const std::optional<std::size_t> slot = aoc::Interner::shortSlot(name);
+    if (!slot || !present[*slot]) {
+      throw std::runtime_error("Unknown wire '" + std::string(name) + "'");
+    }
+    return signal[*slot];
+  }
+};
+
+// Same rules and diagnostics as Circuit. Any error thrown during constant evaluation
+// turns into a compile error pointing at the throw.
+constexpr WireTable evaluateCircuit(const std::string_view text) {
+  struct Operand {
+    bool literal;
+    U16 value; // Wire slot unless literal
+  };
+  struct ConstGate {
+    GateTypes opcode;
+    Operand a;
+    Operand b; // Second wire, or the shift amount
+    std::size_t dst;
+  };
+  constexpr U32 SOURCE = ~0U;
+  constexpr U32 UNDRIVEN = ~0U - 1;
+
+  WireTable table;
+  std::vector<ConstGate> gates;
+  std::vector<U32> driver(aoc::Interner::SHORT_SLOTS, UNDRIVEN);
+
+  // Constexpr stand-in for aoc::parse<U16>
+  const auto literalOf = [](const std::string_view token) -> std::optional<U16> {
+    U32 value = 0;
+    for (const char ch : token) {
+      if (ch < '0' || ch > '9' || (value = value * 10 + (ch - '0')) > 0xFFFF) {
+        return std::nullopt;
+      }
+    }
+    return token.empty() ? std::nullopt : std::optional<U16>{static_cast<U16>(value)};
+  };
+  const auto wireOf = [&table](const std::string_view name) -> std::size_t {
+    const std::optional<std::size_t> slot = aoc::Interner::shortSlot(name);
+    if (!slot) {
+      throw std::runtime_error("Embedded circuits only support 1-2 letter wire names, got '" + std::string(name) + "'");
+    }
+    table.present[*slot] = true;
+    return *slot;
+  };
+  const auto operandOf = [&](const std::string_view token) -> Operand {
+    if (const std::optional<U16> literal = literalOf(token)) {
+      return {true, *literal};
+    }
+    return {false, static_cast<U16>(wireOf(token))};
+  };
+  const auto drive = [&](const std::size_t wire, const U32 gate) {
+    if (driver[wire] != UNDRIVEN) {
+      throw std::runtime_error("A wire is driven more than once");
+    }
+    driver[wire] = gate;
+  };
+
+  std::array<std::string_view, 5> tokens;
+  for (std::size_t pos = 0; pos < text.size();) {
+    const std::size_t end = std::min(text.find('\n', pos), text.size());
+    std::string_view line = text.substr(pos, end - pos);
+    pos = end + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    const std::size_t count = splitTokens(line, tokens);
+    if (count == 0) {
+      continue;
+    }
+    if (count < 3 || tokens[count - 2] != "->") {
+      throw std::runtime_error("Malformed circuit line: '" + std::string(line) + "'");
+    }
+    const std::size_t out = wireOf(tokens[count - 1]);
+    const U32 gate = static_cast<U32>(gates.size());
+
+    if (count == 3) {
+      if (const std::optional<U16> signal = literalOf(tokens[0])) { // Direct input signal
+        drive(out, SOURCE);
+        table.signal[out] = *signal;
+      }
+      else { // Wire -> wire connection
+        drive(out, gate);
+        gates.push_back({GateTypes::PASSTHROUGH, operandOf(tokens[0]), {true, 0}, out});
+      }
+    }
+    else if (count == 4 && tokens[0] == "NOT") {
+      drive(out, gate);
+      gates.push_back({GateTypes::NOT, operandOf(tokens[1]), {true, 0}, out});
+    }
+    else if (count == 5 && (tokens[1] == "AND" || tokens[1] == "OR")) {
+      drive(out, gate);
+      gates.push_back({tokens[1] == "AND" ? GateTypes::AND : GateTypes::OR, operandOf(tokens[0]), operandOf(tokens[2]), out});
+    }
+    else if (count == 5 && (tokens[1] == "LSHIFT" || tokens[1] == "RSHIFT")) {
+      const std::optional<U16> shift = literalOf(tokens[2]);
+      if (!shift || *shift > 15) {
+        throw std::runtime_error("Invalid shift in circuit line: '" + std::string(line) + "'");
+      }
+      drive(out, gate);
+      gates.push_back({tokens[1] == "LSHIFT" ? GateTypes::LSHIFT : GateTypes::RSHIFT, operandOf(tokens[0]), {true, *shift}, out});
+    }
+    else {
+      throw std::runtime_error("Malformed circuit line: '" + std::string(line) + "'");
+    }
+  }
+
+  for (std::size_t wire = 0; wire < driver.size(); ++wire) {
+    if (table.present[wire] && driver[wire] == UNDRIVEN) {
+      throw std::runtime_error("Wire is never driven");
+    }
+  }
+
+  // Kahn's algorithm, evaluating each gate as soon as it becomes ready
+  std::vector<U32> pending(gates.size(), 0);
+  std::vector<std::vector<U32>> consumers(aoc::Interner::SHORT_SLOTS);
+  std::vector<U32> ready;
+  for (U32 gate = 0; gate < gates.size(); ++gate) {
+    const bool binary = (gates[gate].opcode == GateTypes::AND || gates[gate].opcode == GateTypes::OR);
+    const std::array<Operand, 2> inputs = {gates[gate].a, binary ? gates[gate].b : Operand{true, 0}};
+    for (const Operand &input : inputs) {
+      if (!input.literal) {
+        consumers[input.value].push_back(gate);
+        pending[gate] += (driver[input.value] != SOURCE);
+      }
+    }
+    if (pending[gate] == 0) {
+      ready.push_back(gate);
+    }
+  }
+
+  const auto valueOf = [&table](const Operand &input) -> U16 { return input.literal ? input.value : table.signal[input.value]; };
+  for (std::size_t next = 0; next < ready.size(); ++next) {
+    const ConstGate &gate = gates[ready[next]];
+    const U16 a = valueOf(gate.a);
+    const U16 b = valueOf(gate.b);
+    U16 result = 0;
+    switch(gate.opcode) {
+      case GateTypes::AND: result = a & b; break;
+      case GateTypes::OR: result = a | b; break;
+      case GateTypes::NOT: result = ~a; break;
+      case GateTypes::LSHIFT: result = a << b; break;
+      case GateTypes::RSHIFT: result = a >> b; break;
+      case GateTypes::PASSTHROUGH: result = a; break;
+      default: throw std::runtime_error("Unsupported gate type");
+    }
+    table.signal[gate.dst] = result;
+    for (const U32 consumer : consumers[gate.dst]) {
+      if (--pending[consumer] == 0) {
+        ready.push_back(consumer);
+      }
+    }
+  }
+  if (ready.size() != gates.size()) {
+    throw std::runtime_error("Circuit has a cycle");
+  }
+  return table;
+}
+
+// The example circuit from the puzzle statement
+static_assert(evaluateCircuit("123 -> x\n456 -> y\nx AND y -> d\nx OR y -> e\nx LSHIFT 2 -> f\n"
+                              "y RSHIFT 2 -> g\nNOT x -> h\nNOT y -> i\n").get("h") == 65412);
+
+#ifdef AOC_EMBED
+#include "input/day7.embed.hpp"
+// Parsed and evaluated by the compiler; only the wire table ends up in the binary
+constexpr WireTable EMBEDDED_WIRES = evaluateCircuit(EMBEDDED_INPUT);
+#endif
+
+const aoc::Registrar registrar({
+  "day7",
+  "input/day7.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.lines()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.lines()); }
+});
+
+const aoc::bench::Registrar variants({
+  {"day7", "part1_fixed_point", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_fixed_point(file.lines()); }},
+  {"day7", "part1_switch", [](const aoc::MappedInput &file) -> aoc::Answer { return part1_switch(file.lines()); }},
+  {"day7", "part2_full", [](const aoc::MappedInput &file) -> aoc::Answer { return part2_full(file.lines()); }},
+  {"day7", "sweep_b_scalar", [](const aoc::MappedInput &file) -> aoc::Answer { return sweepScalar(file.lines()); }},
+  {"day7", "sweep_b_lanes", [](const aoc::MappedInput &file) -> aoc::Answer { return sweepLanes(file.lines()); }}
+});
+
+}
+
+#ifndef AOC_DRIVER
 int main() {
-  const std::vector<std::string> input = aoc::getMultiLineInput("input/day7.dat");
-  part1(input);
-  part2(input);
+  const aoc::MappedInput file("input/day7.dat");
+  const std::vector<std::string_view> input = file.lines();
+
+  const auto start1 = std::chrono::high_resolution_clock::now();
+  std::cout << "Signal provided to wire 'a': " << part1(input) << std::endl;
+  const auto end1 = std::chrono::high_resolution_clock::now();
+
+#ifdef AOC_EMBED
+  std::cout << "Signal provided to wire 'a' (evaluated at compile time): " << EMBEDDED_WIRES.get("a") << std::endl;
+#endif
+
+  const auto start2 = std::chrono::high_resolution_clock::now();
+  std::cout << "Signal provided to wire 'a' (fixed point): " << part1_fixed_point(input) << std::endl;
+  const auto end2 = std::chrono::high_resolution_clock::now();
+
+  const auto start3 = std::chrono::high_resolution_clock::now();
+  std::cout << "Signal provided to wire 'a' after overriding 'b': " << part2(input) << std::endl;
+  const auto end3 = std::chrono::high_resolution_clock::now();
+
+  // What-if queries: override 'b' many times, recomputing only the affected cone
+  constexpr U32 queries = 1000;
+  Circuit circuit(input);
+  circuit.get("a");
+  std::size_t recomputed = 0;
+  const auto start4 = std::chrono::high_resolution_clock::now();
+  for (U32 value = 0; value < queries; ++value) {
+    circuit.override("b", static_cast<U16>(value * 65u));
+    aoc::bench::DoNotOptimize(circuit.get("a"));
+    recomputed += circuit.recomputedGates();
+  }
+  const auto end4 = std::chrono::high_resolution_clock::now();
+
+  // Every possible signal on 'b', one full pass per value vs LANES values per pass
+  const auto start5 = std::chrono::high_resolution_clock::now();
+  const U64 scalar_sum = sweepScalar(input);
+  const auto end5 = std::chrono::high_resolution_clock::now();
+  const auto start6 = std::chrono::high_resolution_clock::now();
+  const U64 lanes_sum = sweepLanes(input);
+  const auto end6 = std::chrono::high_resolution_clock::now();
+  RUNTIME_ASSERT(scalar_sum == lanes_sum);
+
+  // Per-gate evaluation cost, virtual hierarchy vs opcode switch, on a generated circuit
+  const std::vector<std::string> generated = generateCircuit(100'000, 2015);
+  const std::vector<std::string_view> generated_input(generated.begin(), generated.end());
+  GateCircuit<VirtualGate> virtual_circuit(generated_input);
+  GateCircuit<SwitchGate> switch_circuit(generated_input);
+  virtual_circuit.settle();
+  switch_circuit.settle();
+  const std::string_view last = generated_input.back().substr(generated_input.back().rfind(' ') + 1);
+  RUNTIME_ASSERT(virtual_circuit.signal(last) == switch_circuit.signal(last));
+  const aoc::bench::Config config{.max_seconds = 0.5};
+  const aoc::bench::Stats virtual_stats = aoc::bench::measure([&]() { virtual_circuit.activateAll(); return virtual_circuit.signal(last); }, config);
+  const aoc::bench::Stats switch_stats = aoc::bench::measure([&]() { switch_circuit.activateAll(); return switch_circuit.signal(last); }, config);
+  const F64 ns_per_gate = 1e6 / static_cast<F64>(virtual_circuit.gateCount());
+
+  const std::chrono::duration<F32, std::milli> elapsed1 = end1 - start1;
+  const std::chrono::duration<F32, std::milli> elapsed2 = end2 - start2;
+  const std::chrono::duration<F32, std::milli> elapsed3 = end3 - start3;
+  const std::chrono::duration<F32, std::milli> elapsed4 = end4 - start4;
+  std::cout << "Elapsed time (compiled tape):\t" << elapsed1.count() << " ms" << std::endl;
+  std::cout << "Elapsed time (fixed point):\t" << elapsed2.count() << " ms" << std::endl;
+  std::cout << "Elapsed time (incremental part 2):\t" << elapsed3.count() << " ms" << std::endl;
+  std::cout << "Elapsed time (" << queries << " overrides of 'b'):\t" << elapsed4.count() << " ms, "
+            << static_cast<F64>(recomputed) / queries << " of " << circuit.gateCount() << " gates recomputed per query" << std::endl;
+
+  const std::chrono::duration<F32, std::milli> elapsed5 = end5 - start5;
+  const std::chrono::duration<F32, std::milli> elapsed6 = end6 - start6;
+  std::cout << "Elapsed time (sweep 'b', scalar):\t" << elapsed5.count() << " ms" << std::endl;
+  std::cout << "Elapsed time (sweep 'b', " << Circuit::LANES << " lanes):\t" << elapsed6.count() << " ms" << std::endl;
+  std::cout << "Per-gate cost (" << virtual_circuit.gateCount() << " generated gates, virtual):\t" << virtual_stats.median * ns_per_gate << " ns" << std::endl;
+  std::cout << "Per-gate cost (" << switch_circuit.gateCount() << " generated gates, switch):\t" << switch_stats.median * ns_per_gate << " ns" << std::endl;
   return 0;
 }
+#endif
 
-// TODO :: Change these to string_views to avoid duplication!
-std::vector<std::vector<std::string>> tokenize_input(const std::vector<std::string> &input) {
-  const auto to_string_views = [](const std::string &s) -> std::string_view { return std::string_view(s); };
-  const auto enumerated_string_views = input | std::views::transform(to_string_views) | std::views::enumerate;
+namespace {
+
+U32 Circuit::wireId(const std::string_view token) {
+  const U32 id = names.intern(token);
+  if (id == driver.size()) {
+    // Literal operands (e.g. "1 AND fi") are constant wires named after their value
+    const aoc::ParseResult<U16> literal = aoc::parse<U16>(token);
+    driver.push_back(literal ? SOURCE : UNDRIVEN);
+    signals.push_back(literal.value);
+  }
+  return id;
+}
+
+void Circuit::drive(const U32 wire, const U32 gate) {
+  if (driver[wire] != UNDRIVEN) {
+    throw std::runtime_error("Wire '" + std::string(names.name(wire)) + "' is driven more than once");
+  }
+  driver[wire] = gate;
+}
+
+Circuit::Circuit(const std::vector<std::string_view> &input) {
+  // Gates in input order; sorted into 'tape' below
+  Tape gates;
+  const auto addGate = [&gates](const GateTypes opcode, const U32 a, const U32 b, const U32 out) {
+    gates.opcode.push_back(opcode);
+    gates.srcA.push_back(a);
+    gates.srcB.push_back(b);
+    gates.dst.push_back(out);
+  };
+
+  std::array<std::string_view, 5> tokens;
+  for (const std::string_view line : input) {
+    const std::size_t count = splitTokens(line, tokens);
+    if (count < 3 || tokens[count - 2] != "->") {
+      throw std::runtime_error("Malformed circuit line: '" + std::string(line) + "'");
+    }
+    const U32 gate = static_cast<U32>(gates.opcode.size());
+    const U32 out = wireId(tokens[count - 1]);
+
+    if (count == 3) {
+      const aoc::ParseResult<U16> signal = aoc::parse<U16>(tokens[0]);
+      if (signal) { // Direct input signal
+        drive(out, SOURCE);
+        signals[out] = signal.value;
+      }
+      else { // Wire -> wire connection
+        drive(out, gate);
+        addGate(GateTypes::PASSTHROUGH, wireId(tokens[0]), 0, out);
+      }
+    }
+    else if (count == 4 && tokens[0] == "NOT") {
+      drive(out, gate);
+      addGate(GateTypes::NOT, wireId(tokens[1]), 0, out);
+    }
+    else if (count == 5) {
+      drive(out, gate);
+      const std::string_view type = tokens[1];
+      if (type == "AND") {
+        addGate(GateTypes::AND, wireId(tokens[0]), wireId(tokens[2]), out);
+      }
+      else if (type == "OR") {
+        addGate(GateTypes::OR, wireId(tokens[0]), wireId(tokens[2]), out);
+      }
+      else if (type == "LSHIFT" || type == "RSHIFT") {
+        const aoc::ParseResult<U16> shift = aoc::parse<U16>(tokens[2]);
+        if (!shift || shift.value > 15) {
+          throw std::runtime_error("Invalid shift in circuit line: '" + std::string(line) + "'");
+        }
+        addGate(type == "LSHIFT" ? GateTypes::LSHIFT : GateTypes::RSHIFT, wireId(tokens[0]), shift.value, out);
+      }
+      else {
+        throw std::runtime_error("Unknown gate in circuit line: '" + std::string(line) + "'");
+      }
+    }
+    else {
+      throw std::runtime_error("Malformed circuit line: '" + std::string(line) + "'");
+    }
+  }
 
+  for (U32 wire = 0; wire < names.size(); ++wire) {
+    if (driver[wire] == UNDRIVEN) {
+      throw std::runtime_error("Wire '" + std::string(names.name(wire)) + "' is never driven");
+    }
+  }
+
+  // Kahn's algorithm: a gate is ready once every gate-driven input has been emitted
+  const std::size_t gate_count = gates.opcode.size();
+  const auto hasSecondWire = [](const GateTypes opcode) { return opcode == GateTypes::AND || opcode == GateTypes::OR; };
+  std::vector<U32> pending(gate_count, 0);
+  std::vector<U32> consumer_start(names.size() + 1, 0);
+  for (U32 gate = 0; gate < gate_count; ++gate) {
+    const auto addInput = [&](const U32 wire) {
+      ++consumer_start[wire + 1];
+      pending[gate] += (driver[wire] != SOURCE);
+    };
+    addInput(gates.srcA[gate]);
+    if (hasSecondWire(gates.opcode[gate])) {
+      addInput(gates.srcB[gate]);
+    }
+  }
+  std::partial_sum(consumer_start.begin(), consumer_start.end(), consumer_start.begin());
+  std::vector<U32> consumers(consumer_start.back());
+  std::vector<U32> fill(consumer_start.begin(), consumer_start.end() - 1);
+  for (U32 gate = 0; gate < gate_count; ++gate) {
+    consumers[fill[gates.srcA[gate]]++] = gate;
+    if (hasSecondWire(gates.opcode[gate])) {
+      consumers[fill[gates.srcB[gate]]++] = gate;
+    }
+  }
+
+  std::vector<U32> order;
+  order.reserve(gate_count);
+  for (U32 gate = 0; gate < gate_count; ++gate) {
+    if (pending[gate] == 0) {
+      order.push_back(gate);
+    }
+  }
+  for (std::size_t next = 0; next < order.size(); ++next) {
+    const U32 out = gates.dst[order[next]];
+    for (U32 i = consumer_start[out]; i < consumer_start[out + 1]; ++i) {
+      if (--pending[consumers[i]] == 0) {
+        order.push_back(consumers[i]);
+      }
+    }
+  }
+
+  if (order.size() != gate_count) {
+    std::string cycle;
+    for (U32 gate = 0; gate < gate_count; ++gate) {
+      if (pending[gate] != 0) {
+        cycle += (cycle.empty() ? "" : ", ") + std::string(names.name(gates.dst[gate]));
+      }
+    }
+    throw std::runtime_error("Circuit has a cycle; wires that can never be set: " + cycle);
+  }
+
+  tape.opcode.reserve(gate_count);
+  tape.srcA.reserve(gate_count);
+  tape.srcB.reserve(gate_count);
+  tape.dst.reserve(gate_count);
+  std::vector<U32> position(gate_count);
+  for (const U32 gate : order) {
+    position[gate] = static_cast<U32>(tape.opcode.size());
+    driver[gates.dst[gate]] = position[gate];
+    tape.opcode.push_back(gates.opcode[gate]);
+    tape.srcA.push_back(gates.srcA[gate]);
+    tape.srcB.push_back(gates.srcB[gate]);
+    tape.dst.push_back(gates.dst[gate]);
+  }
+
+  // Keep the dependency graph for incremental updates, in tape positions
+  for (U32 &consumer : consumers) {
+    consumer = position[consumer];
+  }
+  this->consumer_start = std::move(consumer_start);
+  this->consumers = std::move(consumers);
+  dirty.assign(gate_count, false);
+}
+
+U16 Circuit::apply(const GateTypes opcode, const U16 a, const U32 b, const U16 *signal) {
+  switch(opcode) {
+    case GateTypes::AND: return a & signal[b];
+    case GateTypes::OR: return a | signal[b];
+    case GateTypes::NOT: return ~a;
+    case GateTypes::LSHIFT: return a << b;
+    case GateTypes::RSHIFT: return a >> b;
+    case GateTypes::PASSTHROUGH: return a;
+    default: throw std::runtime_error("Unsupported gate type on tape");
+  }
+}
+
+void Circuit::evaluate() {
+  const std::size_t size = tape.opcode.size();
+  const GateTypes *opcode = tape.opcode.data();
+  const U32 *srcA = tape.srcA.data();
+  const U32 *srcB = tape.srcB.data();
+  const U32 *dst = tape.dst.data();
+  U16 *signal = signals.data();
+
+  for (std::size_t i = 0; i < size; ++i) {
+    signal[dst[i]] = apply(opcode[i], signal[srcA[i]], srcB[i], signal);
+  }
+
+  // Everything is consistent now, pending dirty marks are moot
+  queue = {};
+  dirty.assign(size, false);
+  recomputed = size;
+  evaluated = true;
+}
+
+void Circuit::markConsumers(const U32 wire) {
+  for (U32 i = consumer_start[wire]; i < consumer_start[wire + 1]; ++i) {
+    const U32 gate = consumers[i];
+    if (!dirty[gate]) {
+      dirty[gate] = true;
+      queue.push(gate);
+    }
+  }
+}
+
+void Circuit::update() {
+  recomputed = 0;
+  while (!queue.empty()) {
+    const U32 gate = queue.top();
+    queue.pop();
+    dirty[gate] = false;
+    ++recomputed;
+
+    const U32 out = tape.dst[gate];
+    const U16 result = apply(tape.opcode[gate], signals[tape.srcA[gate]], tape.srcB[gate], signals.data());
+    // Unchanged outputs stop the propagation early
+    if (result != signals[out]) {
+      signals[out] = result;
+      markConsumers(out);
+    }
+  }
+}
+
+void Circuit::pin(const U32 wire) {
+  if (driver[wire] != SOURCE) {
+    // The driving gate now just keeps its own output, so full passes respect the override too
+    const U32 gate = driver[wire];
+    tape.opcode[gate] = GateTypes::PASSTHROUGH;
+    tape.srcA[gate] = wire;
+    driver[wire] = SOURCE;
+  }
+}
+
+void Circuit::override(const std::string_view name, const U16 value) {
+  const U32 wire = find(name);
+  pin(wire);
+  if (signals[wire] != value) {
+    signals[wire] = value;
+    if (evaluated) {
+      markConsumers(wire);
+    }
+  }
+}
+
+// One tape pass over lane arrays. Each gate is a fixed-length loop the compiler vectorizes
+// for whatever ISA the calling wrapper targets.
+template <std::size_t LANES>
+[[gnu::always_inline]] inline void runLanes(const GateTypes *opcode, const U32 *srcA, const U32 *srcB, const U32 *dst, const std::size_t size, Circuit::Lanes *lanes) {
+  for (std::size_t i = 0; i < size; ++i) {
+    const U16 *a = lanes[srcA[i]].lane.data();
+    U16 *out = lanes[dst[i]].lane.data();
+    switch(opcode[i]) {
+      case GateTypes::AND: {
+        const U16 *b = lanes[srcB[i]].lane.data();
+        for (std::size_t l = 0; l < LANES; ++l) { out[l] = a[l] & b[l]; }
+        break;
+      }
+      case GateTypes::OR: {
+        const U16 *b = lanes[srcB[i]].lane.data();
+        for (std::size_t l = 0; l < LANES; ++l) { out[l] = a[l] | b[l]; }
+        break;
+      }
+      case GateTypes::NOT: {
+        for (std::size_t l = 0; l < LANES; ++l) { out[l] = ~a[l]; }
+        break;
+      }
+      case GateTypes::LSHIFT: {
+        const U32 shift = srcB[i];
+        for (std::size_t l = 0; l < LANES; ++l) { out[l] = a[l] << shift; }
+        break;
+      }
+      case GateTypes::RSHIFT: {
+        const U32 shift = srcB[i];
+        for (std::size_t l = 0; l < LANES; ++l) { out[l] = a[l] >> shift; }
+        break;
+      }
+      case GateTypes::PASSTHROUGH: {
+        if (out != a) { // Pinned wires pass through themselves
+          std::copy_n(a, LANES, out);
+        }
+        break;
+      }
+      default: throw std::runtime_error("Unsupported gate type on tape");
+    }
+  }
+}
+
+#ifdef AOC_X86
+AOC_TARGET("avx512bw") void runLanesAvx512(const GateTypes *opcode, const U32 *srcA, const U32 *srcB, const U32 *dst, const std::size_t size, Circuit::Lanes *lanes) {
+  runLanes<Circuit::LANES>(opcode, srcA, srcB, dst, size, lanes);
+}
+
+AOC_TARGET("avx2") void runLanesAvx2(const GateTypes *opcode, const U32 *srcA, const U32 *srcB, const U32 *dst, const std::size_t size, Circuit::Lanes *lanes) {
+  runLanes<Circuit::LANES>(opcode, srcA, srcB, dst, size, lanes);
+}
+#endif
+
+void evaluateLanes(const GateTypes *opcode, const U32 *srcA, const U32 *srcB, const U32 *dst, const std::size_t size, Circuit::Lanes *lanes) {
+#ifdef AOC_X86
+  if (aoc::cpu::hasAvx512bw()) {
+    return runLanesAvx512(opcode, srcA, srcB, dst, size, lanes);
+  }
+  if (aoc::cpu::hasAvx2()) {
+    return runLanesAvx2(opcode, srcA, srcB, dst, size, lanes);
+  }
+#endif
+  runLanes<Circuit::LANES>(opcode, srcA, srcB, dst, size, lanes);
+}
+
+void Circuit::sweep(const std::string_view input, std::span<const U16> values, const std::string_view output, std::span<U16> results) {
+  if (values.size() != results.size()) {
+    throw std::runtime_error("Circuit::sweep needs one result slot per value");
+  }
+  const U32 in = find(input);
+  const U32 out = find(output);
+  pin(in);
+
+  // Sources are broadcast once; gate outputs are rewritten by every pass
+  std::vector<Lanes> lanes(names.size());
+  for (U32 wire = 0; wire < names.size(); ++wire) {
+    lanes[wire].lane.fill(signals[wire]);
+  }
+
+  for (std::size_t first = 0; first < values.size(); first += LANES) {
+    const std::size_t count = std::min(LANES, values.size() - first);
+    for (std::size_t l = 0; l < LANES; ++l) {
+      lanes[in].lane[l] = values[first + std::min(l, count - 1)]; // Pad the last batch
+    }
+    evaluateLanes(tape.opcode.data(), tape.srcA.data(), tape.srcB.data(), tape.dst.data(), tape.opcode.size(), lanes.data());
+    std::copy_n(lanes[out].lane.begin(), count, results.begin() + first);
+  }
+}
+
+U32 Circuit::find(const std::string_view name) const {
+  const std::optional<U32> id = names.find(name);
+  if (!id) {
+    throw std::runtime_error("Unknown wire '" + std::string(name) + "'");
+  }
+  return *id;
+}
+
+U16 Circuit::get(const std::string_view name) {
+  if (!evaluated) {
+    evaluate();
+  }
+  else if (!queue.empty()) {
+    update();
+  }
+  else {
+    recomputed = 0;
+  }
+  return signals[find(name)];
+}
+
+U16 part1(const std::vector<std::string_view> &input) {
+  Circuit circuit(input);
+  return circuit.get("a");
+}
+
+U16 part2(const std::vector<std::string_view> &input) {
+  Circuit circuit(input);
+  circuit.override("b", circuit.get("a"));
+  return circuit.get("a");
+}
+
+U64 sweepScalar(const std::vector<std::string_view> &input) {
+  Circuit circuit(input);
+  U64 total = 0;
+  for (U32 value = 0; value <= 0xFFFF; ++value) {
+    circuit.override("b", static_cast<U16>(value));
+    circuit.evaluate();
+    total += circuit.get("a");
+  }
+  return total;
+}
+
+U64 sweepLanes(const std::vector<std::string_view> &input) {
+  Circuit circuit(input);
+  std::vector<U16> values(0x10000);
+  std::iota(values.begin(), values.end(), U16{0});
+  std::vector<U16> results(values.size());
+  circuit.sweep("b", values, "a", results);
+  return std::accumulate(results.begin(), results.end(), U64{0});
+}
+
+U16 part2_full(const std::vector<std::string_view> &input) {
+  const U16 a = part1(input);
+  Circuit circuit(input);
+  circuit.override("b", a);
+  circuit.evaluate();
+  return circuit.get("a");
+}
+
+// TODO :: Change these to string_views to avoid duplication!
+std::vector<std::vector<std::string>> tokenize_input(const std::vector<std::string_view> &input) {
   // Collect all the wire definitions
   std::vector<std::vector<std::string>> tokenized_input(input.size());
   std::vector<std::string> *tokens;
-  for (const auto [index, line] : enumerated_string_views) {
-    std::istringstream iss(line.data());
+  for (std::size_t index = 0; index < input.size(); ++index) {
+    std::istringstream iss{std::string(input[index])};
     tokens = &tokenized_input[index];
     tokens->reserve(5); // longest line will have 5 tokens
     std::string token;
@@ -385,199 +1227,179 @@ std::vector<std::vector<std::string>> tokenize_input(const std::vector<std::stri
   return tokenized_input;
 }
 
-void part1(const std::vector<std::string> &input) {
-  std::vector<std::variant<ANDGate, ORGate, NOTGate, LSHIFTGate, RSHIFTGate, PASSTHROUGHGate>> gates;
-  std::unordered_map<std::string, Wire> wires;
-  std::vector<Wires> wire_groupings; // Used as a cache
-
-  // Reserve space to avoid re-allocation of underlying memory,
-  // which invalidates memory addresses we need later on!
-  gates.reserve(input.size());
-  wires.reserve(input.size());
-  wire_groupings.reserve(input.size());
-
-  // Collect all the wire definitions
+template <typename GATE>
+aoc::Interner GateCircuit<GATE>::internWires(const std::vector<std::string_view> &input) {
+  aoc::Interner ids;
+  std::array<std::string_view, 5> tokens;
   for (const std::string_view line : input) {
-    std::istringstream iss(line.data());
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) {
-      tokens.push_back(token);
-    }
-    // Len = 3 // RVALUE (direct input signal) OR ANOTHER WIRE
-    // Len = 4 // NOT GATE
-    // Len = 5 // AND,OR,LSHIFT,RSHIFT GATE
-    if (tokens.size() == 3) {
-      // TODO :: NEED TO ADD SUPPORT FOR WIRE -> WIRE CONNECTION!!!
-      // IDEA: Create a "WIREGate" that sets output to the input!
-      const U16 signal = static_cast<U16>(aoc::to_long(tokens[0].data()));
-      wires.erase(tokens[2]); // Force overwrite since these wires already have a signal!
-      wires.emplace(tokens[2], Wire{true, signal, tokens[2]});
-    }
-    else if (tokens.size() == 4) {
-      wires.emplace(tokens[1], Wire{false, 0b0, tokens[1]});
-      wires.emplace(tokens[3], Wire{false, 0b0, tokens[3]});
-    }
-    else { // tokens.size() == 5
-      wires.emplace(tokens[0], Wire{false, 0b0, tokens[0]});
-      if (tokens[1] != "LSHIFT" && tokens[1] != "RSHIFT") { // No second wire!
-        wires.emplace(tokens[2], Wire{false, 0b0, tokens[2]});
+    const std::size_t count = splitTokens(line, tokens);
+    // Everything but "->" and the gate keyword is a wire, a literal or a shift amount
+    for (std::size_t i = 0; i < count; ++i) {
+      const bool keyword = (i == count - 2) || (count == 4 && i == 0) || (count == 5 && i == 1);
+      if (!keyword) {
+        ids.intern(tokens[i]);
       }
-      wires.emplace(tokens[4], Wire{false, 0b0, tokens[4]});
     }
   }
+  return ids;
+}
+
+template <typename GATE>
+GateCircuit<GATE>::GateCircuit(const std::vector<std::string_view> &input) : signals(internWires(input)) {
+  gates.reserve(input.size());
 
-  std::cerr << "Size of wires: " << wires.size() << std::endl;
-  for (const auto &[name, wire] : wires) {
-    std::cerr << "Found wire \"" << name << "\" with signal: " << wire.signal << std::endl;
+  // Literal operands (e.g. "1 AND fi") become wires that are already set
+  for (U32 id = 0; id < signals.size(); ++id) {
+    if (const aoc::ParseResult<U16> literal = aoc::parse<U16>(signals.view(id).label)) {
+      signals.assign(id, literal.value);
+    }
   }
 
   // Collect all the gates and assign the wires
-  U64 directSignalCount = 0;
+  std::array<std::string_view, 5> tokens;
   for (const std::string_view line : input) {
-    std::istringstream iss(line.data());
-    std::vector<std::string> tokens;
-    {
-      std::string token;
-      while (iss >> token) {
-        tokens.push_back(token);
-      }
-    }
+    const std::size_t count = splitTokens(line, tokens);
+    // Len = 3 // RVALUE (direct input signal) OR ANOTHER WIRE
     // Len = 4 // NOT GATE
     // Len = 5 // AND,OR,LSHIFT,RSHIFT GATE
-    // 
-    std::cout << "\nProcessing line: " << line << std::endl;
-    if (tokens.size() == 4) {
-      Wire &in = wires.at(tokens[1]);
-      Wire &out = wires.at(tokens[3]);
-      gates.emplace_back(NOTGate{out, in});
-      std::cerr << "Creating NOT gate with input wire " << tokens[1] << std::endl;
-    }
-    else if (tokens.size() == 5) {
-      Wire &out = wires.at(tokens[4]);
+    if (count == 4) {
+      const U32 a = signals.id(tokens[1]);
+      addGate(GateTypes::NOT, signals.id(tokens[3]), a, a, 0);
+    }
+    else if (count == 5) {
+      const U32 out = signals.id(tokens[4]);
+      const U32 a = signals.id(tokens[0]);
       const std::string_view type = tokens[1];
       if (type == "AND") {
-        wire_groupings.emplace_back(Wires{&wires.at(tokens[0]), &wires.at(tokens[2])});
-        gates.emplace_back(ANDGate(out, wire_groupings.back()));
-        std::cerr << "Creating AND gate with input wires " << tokens[0] << " and " << tokens[2] << std::endl;
+        addGate(GateTypes::AND, out, a, signals.id(tokens[2]), 0);
       }
       else if (type == "OR") {
-        wire_groupings.emplace_back(Wires{&wires.at(tokens[0]), &wires.at(tokens[2])});
-        gates.emplace_back(ORGate(out, wire_groupings.back()));
-        std::cerr << "Creating OR gate with input wires " << tokens[0] << " and " << tokens[2] << std::endl;
+        addGate(GateTypes::OR, out, a, signals.id(tokens[2]), 0);
       }
       else if (type == "LSHIFT") {
-        Wire &in = wires.at(tokens[0]);
-        const U16 shift = static_cast<U16>(aoc::to_long(tokens[2].data()));
-        gates.emplace_back(LSHIFTGate(shift, out, in));
-        std::cerr << "Creating LSHIFT gate with input wire " << tokens[0] << " and shift " << shift << std::endl;
+        addGate(GateTypes::LSHIFT, out, a, a, aoc::parse<U16>(tokens[2]).value);
       }
       else if (type == "RSHIFT") {
-        Wire &in = wires.at(tokens[0]);
-        const U16 shift = static_cast<U16>(aoc::to_long(tokens[2].data()));
-        gates.emplace_back(RSHIFTGate(shift, out, in));
-        std::cerr << "Creating LSHIFT gate with input wire " << tokens[0] << " and shift " << shift << std::endl;
+        addGate(GateTypes::RSHIFT, out, a, a, aoc::parse<U16>(tokens[2]).value);
       }
       else {
-        std::cerr << "THIS CANNOT HAPPEN" << std::endl;
-        std::exit(1);
+        throw std::runtime_error("Unknown gate in circuit line: '" + std::string(line) + "'");
       }
     }
     else {
-      // TODO :: Need to clean up later!
-      std::cerr << "DIRECT SIGNAL LINE: " << line << std::endl;
-      ++directSignalCount;
-      bool is_pass_through = std::any_of(tokens[0].cbegin(), tokens[0].cend(), [](const char ch) -> bool { return !std::isalpha(ch); });
-      if (is_pass_through) {
-        Wire &in = wires.at(tokens[0]);
-        Wire &out = wires.at(tokens[2]);
-        gates.emplace_back(PASSTHROUGHGate(out, in));
+      const aoc::ParseResult<U16> signal = aoc::parse<U16>(tokens[0]);
+      const U32 out = signals.id(tokens[2]);
+      if (signal) { // Direct input signal
+        signals.assign(out, signal.value);
       }
-      else {
-        // Skipping direct signal feed line!
+      else { // Wire -> wire connection
+        const U32 a = signals.id(tokens[0]);
+        addGate(GateTypes::PASSTHROUGH, out, a, a, 0);
       }
     }
   }
+}
 
-  std::cerr << "There are " << directSignalCount << " direct signal lines." << std::endl;
-  std::cerr << "There are " << wires.size() << " wires." << std::endl;
-  std::cerr << "There are " << gates.size() << " gates." << std::endl;
+template <typename GATE>
+void GateCircuit<GATE>::addGate(const GateTypes type, const U32 out, const U32 a, const U32 b, const U16 shift) {
+  if constexpr (std::is_same_v<GATE, SwitchGate>) {
+    gates.push_back(SwitchGate{type, out, {a, b}, shift});
+  }
+  else {
+    switch(type) {
+      case GateTypes::AND: gates.emplace_back(ANDGate(out, {a, b})); break;
+      case GateTypes::OR: gates.emplace_back(ORGate(out, {a, b})); break;
+      case GateTypes::NOT: gates.emplace_back(NOTGate(out, a)); break;
+      case GateTypes::LSHIFT: gates.emplace_back(LSHIFTGate(shift, out, a)); break;
+      case GateTypes::RSHIFT: gates.emplace_back(RSHIFTGate(shift, out, a)); break;
+      case GateTypes::PASSTHROUGH: gates.emplace_back(PASSTHROUGHGate(out, a)); break;
+      default: throw std::runtime_error("Unsupported gate type");
+    }
+  }
+}
+
+template <typename GATE>
+void GateCircuit<GATE>::settle() {
+  const auto tryActivate = [this](GATE &gate) -> bool {
+    if constexpr (std::is_same_v<GATE, SwitchGate>) {
+      return gate.try_activate(signals);
+    }
+    else {
+      return std::visit([this](auto &g) { return g.try_activate(signals); }, gate);
+    }
+  };
 
   std::vector<bool> status(gates.size());
   U64 old_count = 0;
   do {
-    std::cerr << "Visiting ..." << std::endl;
     U64 i = 0;
-    for (auto &gate : gates) {
-      std::visit([&](auto &g) {
-        std::cerr << "\n\nRunning gate: " << g.type() << std::endl;
-        g.check_input();
-        std::cerr << "----------------------" << std::endl;
-        status[i++] = g.try_activate();
-      }, gate);
+    for (GATE &gate : gates) {
+      status[i++] = tryActivate(gate);
     }
 
     const U64 count = std::count_if(status.cbegin(), status.cend(), [](const bool flag) -> bool { return flag;});
-    std::cerr << "Number of gates passing the check: " << count << std::endl;
     if (old_count == count) {
-      std::cerr << "Invalid circuit detected!" << std::endl;
-      std::exit(1);
+      throw std::runtime_error("Invalid circuit detected: no gate made progress");
     }
     old_count = count;
-    std::cerr << "\n\n";
   } while (!std::all_of(status.cbegin(), status.cend(), [](const bool flag) { return flag;}));
+}
 
-  std::vector<std::string_view> keys;
-  keys.reserve(wires.size());
-  for (const auto &[key,wire] : wires) {
-    keys.push_back(key);
-  }
-  std::sort(keys.begin(), keys.end());
-  for (const std::string_view key : keys) {
-    std::cout << key << ": " << wires[std::string(key)].signal << std::endl;
+template <typename GATE>
+void GateCircuit<GATE>::activateAll() {
+  for (GATE &gate : gates) {
+    if constexpr (std::is_same_v<GATE, SwitchGate>) {
+      signals.assign(gate.output, gate.activate(signals));
+    }
+    else {
+      std::visit([this](auto &g) { signals.assign(g.output, g.activate(g.load(signals))); }, gate);
+    }
   }
-
-/*
-  Wire in {true, 0b0000000000000111, "a"};
-  Wire out{false, 0b0, "b"};
-  Wire out2{false, 0b0, "c"};
-  NOTGate gate1(in, out);
-  NOTGate gate2(out, out2);
-
-  std::cerr << "Out wire output1: " << std::bitset<16>(gate1.output.signal) << std::endl;
-  std::cerr << "Out wire output2: " << std::bitset<16>(gate2.output.signal) << std::endl;
-  gate1.try_activate();
-  std::cerr << "Out wire output1: " << std::bitset<16>(gate1.output.signal) << std::endl;
-  std::cerr << "Out wire output2: " << std::bitset<16>(gate2.output.signal) << std::endl;
-  gate2.try_activate();
-  std::cerr << "Out wire output1: " << std::bitset<16>(gate1.output.signal) << std::endl;
-  std::cerr << "Out wire output2: " << std::bitset<16>(gate2.output.signal) << std::endl;
-
-  Wires in1_2 {{{true, 0b0000000000000111, "a"}, {true, 0b0000000000000101, "b"}}};
-  Wire out1_2 {false, 0b0, "c"};
-  ANDGate gate3{in1_2, out1_2};
-  std::cerr << "Out wire output3: " << std::bitset<16>(gate3.output.signal) << std::endl;
-  gate3.try_activate();
-  std::cerr << "Out wire output3: " << std::bitset<16>(gate3.output.signal) << std::endl;
-*/
 }
 
-void part2(const std::vector<std::string> &input) {
+U16 part1_fixed_point(const std::vector<std::string_view> &input) {
+  GateCircuit<VirtualGate> circuit(input);
+  circuit.settle();
+  return circuit.signal("a");
 }
 
- void parseCircuit(const std::vector<std::string> &input) {
-  std::vector<Wire> wires;
+U16 part1_switch(const std::vector<std::string_view> &input) {
+  GateCircuit<SwitchGate> circuit(input);
+  circuit.settle();
+  return circuit.signal("a");
+}
 
-  //using GateOpVariant = std::variant<Gate<decltype(Gate::AND)>, Gate<decltype(Gate::OR)>, Gate<decltype(NOT)>, Gate<decltype(LSHIFT), Gate<decltype(RSHIFT)>>;
-  //std::vector<GateOpVariant>;
+std::vector<std::string> generateCircuit(const std::size_t gates, const U32 seed) {
+  constexpr std::size_t sources = 16;
+  constexpr std::array<std::string_view, 6> types = {"AND", "OR", "NOT", "LSHIFT", "RSHIFT", "->"};
+  std::mt19937 rng(seed);
+  const auto wire = [](const std::size_t index) { return std::string("w").append(std::to_string(index)); };
 
-  //using GateVariant = std::variant<Gate<U16 (*)(const std::vector<Wire> &), std::vector<Wire>, Wire>, Gate<U16 (*)(const Wire &), Wire, Wire>>;
+  std::vector<std::string> lines;
+  lines.reserve(sources + gates);
+  for (std::size_t i = 0; i < sources; ++i) {
+    lines.push_back(std::to_string(rng() & 0xFFFF) + " -> " + wire(i));
+  }
+  // Inputs always come from earlier wires, so the circuit can't have a cycle
+  for (std::size_t i = sources; i < sources + gates; ++i) {
+    const std::string a = wire(rng() % i);
+    const std::string b = wire(rng() % i);
+    const std::string out = " -> " + wire(i);
+    const std::string_view type = types[rng() % types.size()];
+    if (type == "NOT") {
+      lines.push_back("NOT " + a + out);
+    }
+    else if (type == "->") {
+      lines.push_back(a + out);
+    }
+    else if (type == "LSHIFT" || type == "RSHIFT") {
+      lines.push_back(a + " " + std::string(type) + " " + std::to_string(rng() % 16) + out);
+    }
+    else {
+      lines.push_back(a + " " + std::string(type) + " " + b + out);
+    }
+  }
+  return lines;
+}
 
-  //Wire w1{'a', 0b0011},w2{'b', 0b0000};
-  //std::vector<GateVariant> gate_map;
-  //gate_map.emplace_back(GateFunctions::AND2, &w1, &w2);
-  //GateVariant var = gate_map[0];
-  //Gate<U16(*)(const Wire&), Wire, Wire> g1 = std::get<Gate<U16(*)(const Wire&), Wire, Wire>>(var);
-  //g1.try_activate();
-  //std::cerr << "Gate output: " << g1.out->signal << std::endl;
 }
@@ -2,30 +2,48 @@
 
 #include <libs/util.hpp>
 
+namespace {
+
 /*
-void part1(const std::vector<char> &input);
-void part2(const std::vector<char> &input);
-void part1(const std::vector<std::string> &input);
-void part2(const std::vector<std::string> &input);
+I64 part1(const std::span<const char> input);
+I64 part2(const std::span<const char> input);
+I64 part1(const std::vector<std::string_view> &input);
+I64 part2(const std::vector<std::string_view> &input);
+
+const aoc::Registrar registrar({
+  "dayX",
+  "input/dayX.dat",
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part1(file.singleLine()); },
+  [](const aoc::MappedInput &file) -> aoc::Answer { return part2(file.lines()); }
+});
 */
 
+}
+
+#ifndef AOC_DRIVER
 int main() {
   std::cout << "THIS IS A TEMPLATE C++ PROGRAM" << std::endl;
-  //const std::vector<char> input = aoc::getSingleLineInput("input/dayX.dat");
-  //const std::vector<char> input = aoc::getMultiLineInput("input/dayX.dat");
-  //part1(input);
-  //part2(input);
+  //const aoc::MappedInput file("input/dayX.dat");
+  //const std::span<const char> input = file.singleLine();
+  //const std::vector<std::string_view> input = file.lines();
+  //std::cout << "Part 1: " << part1(input) << std::endl;
+  //std::cout << "Part 2: " << part2(input) << std::endl;
   return 0;
 }
+#endif
+
+namespace {
 
 /*
-void part1(const std::vector<char> &input) {
+I64 part1(const std::span<const char> input) {
 }
-void part2(const std::vector<char> &input) {
+I64 part2(const std::span<const char> input) {
 }
 
-void part1(const std::vector<std::string> &input) {
+I64 part1(const std::vector<std::string_view> &input) {
 }
-void part2(const std::vector<std::string> &input) {
+I64 part2(const std::vector<std::string_view> &input) {
 }
 */
+
+}
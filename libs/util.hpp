@@ -3,18 +3,63 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <concepts>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
 #include <fstream>
+#include <functional>
+#include <initializer_list>
 #include <optional>
+#include <set>
 #include <source_location>
+#include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+// Memory-mapped input files are only supported on POSIX systems
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AOC_HAS_MMAP 1
+#endif
+
+// Hardware performance counters are only available through Linux perf_event_open
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define AOC_HAS_PERF_EVENTS 1
+#endif
+
+// SIMD kernels are compiled per instruction set and picked at runtime, so the default
+// build flags don't need -march. SSE2 is part of the x86-64 baseline.
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define AOC_X86 1
+#define AOC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
 #define RUNTIME_ASSERT_IMPL(condition, msg, location)                   \
   do {                                                                  \
     if (!(condition)) {                                                 \
@@ -74,11 +119,274 @@ static inline void closeStdinStream() {
 
 namespace aoc {
   // String processing
-  bool containsChar(const char ch, const std::vector<char> &chars) {
+  inline bool containsChar(const char ch, const std::vector<char> &chars) {
     const auto isEqual = [ch](const char ch2) -> bool { return ch == ch2; };
     return std::any_of(chars.cbegin(), chars.cend(), isEqual);
   }
 
+  constexpr bool isWhitespace(const char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+  }
+
+  // CPU feature detection
+  namespace cpu {
+    inline bool hasAvx2() {
+#ifdef AOC_X86
+      static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+      return supported;
+#else
+      return false;
+#endif
+    }
+
+    // Hardware popcount (every AVX2 CPU has it, SSE2-only ones may not)
+    inline bool hasPopcnt() {
+#ifdef AOC_X86
+      static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt"));
+      return supported;
+#else
+      return false;
+#endif
+    }
+
+    // AVX-512 foundation (32/64-bit lanes)
+    inline bool hasAvx512f() {
+#ifdef AOC_X86
+      static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx512f"));
+      return supported;
+#else
+      return false;
+#endif
+    }
+
+    // AVX-512 with byte/word lanes (needed for 16-bit kernels)
+    inline bool hasAvx512bw() {
+#ifdef AOC_X86
+      static const bool supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx512bw"));
+      return supported;
+#else
+      return false;
+#endif
+    }
+  }
+
+  // Vectorized kernels. Each one has a scalar equivalent that it must agree with.
+  namespace simd {
+#ifdef AOC_X86
+    // Calls sink(offset) for every '\n' in the buffer, in order.
+    template <typename SINK>
+    AOC_TARGET("avx2") void forEachNewlineAvx2(const char *data, const std::size_t size, SINK &sink) {
+      const __m256i newline = _mm256_set1_epi8('\n');
+      std::size_t i = 0;
+      for (; i + 32 <= size; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        U32 mask = static_cast<U32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+        while (mask != 0) {
+          sink(i + std::countr_zero(mask));
+          mask &= mask - 1;
+        }
+      }
+      for (; i < size; ++i) {
+        if (data[i] == '\n') {
+          sink(i);
+        }
+      }
+    }
+
+    template <typename SINK>
+    void forEachNewlineSse2(const char *data, const std::size_t size, SINK &sink) {
+      const __m128i newline = _mm_set1_epi8('\n');
+      std::size_t i = 0;
+      for (; i + 16 <= size; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        U32 mask = static_cast<U32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while (mask != 0) {
+          sink(i + std::countr_zero(mask));
+          mask &= mask - 1;
+        }
+      }
+      for (; i < size; ++i) {
+        if (data[i] == '\n') {
+          sink(i);
+        }
+      }
+    }
+#endif
+
+    template <typename SINK>
+    void forEachNewline(const std::string_view buffer, SINK &&sink) {
+#ifdef AOC_X86
+      if (cpu::hasAvx2()) {
+        forEachNewlineAvx2(buffer.data(), buffer.size(), sink);
+      } else {
+        forEachNewlineSse2(buffer.data(), buffer.size(), sink);
+      }
+#else
+      for (std::size_t i = 0; i < buffer.size(); ++i) {
+        if (buffer[i] == '\n') {
+          sink(i);
+        }
+      }
+#endif
+    }
+  }
+
+  // Offsets of every non-blank line in a buffer, built in a single vectorized pass.
+  // Lines are split on '\n' with a trailing '\r' dropped, and lines left empty are skipped.
+  // Offsets are U32 to keep the index small, which caps buffers at 4 GiB.
+  class LineIndex {
+  private:
+    std::string_view buffer;
+    std::vector<U32> starts;
+    std::vector<U32> ends; // Exclusive
+
+    void add(const std::size_t start, std::size_t end) {
+      if (end > start && buffer[end - 1] == '\r') {
+        --end;
+      }
+      if (end > start) {
+        starts.push_back(static_cast<U32>(start));
+        ends.push_back(static_cast<U32>(end));
+      }
+    }
+
+  public:
+    explicit LineIndex(const std::string_view buf) : buffer(buf) {
+      RUNTIME_ASSERT_MSG(buffer.size() <= UINT32_MAX, "LineIndex only supports buffers up to 4 GiB");
+      std::size_t start = 0;
+      simd::forEachNewline(buffer, [&](const std::size_t newline) {
+        add(start, newline);
+        start = newline + 1;
+      });
+      add(start, buffer.size());
+    }
+
+    std::size_t size() const {
+      return starts.size();
+    }
+
+    std::string_view operator[](const std::size_t i) const {
+      return buffer.substr(starts[i], ends[i] - starts[i]);
+    }
+  };
+
+  // Read-only view over an input file. Regular files are memory-mapped so lines can be
+  // handed out as string_views into the mapping without copying them onto the heap.
+  // Anything that can't be mapped (stdin via "-", pipes, empty files) is read into an
+  // owned buffer instead, so callers never need to care which path was taken.
+  class MappedInput {
+  private:
+    const char *bytes = nullptr;
+    std::size_t length = 0;
+    bool mapped = false;
+    std::string buffer; // Backing storage when the file could not be mapped
+    mutable std::string compacted; // Only used when a single-line input has embedded whitespace
+
+#ifdef AOC_HAS_MMAP
+    void readAll(const int fd) {
+      std::array<char, 1 << 16> chunk;
+      ssize_t count;
+      while ((count = ::read(fd, chunk.data(), chunk.size())) != 0) {
+        if (count < 0 && errno == EINTR) {
+          continue;
+        }
+        RUNTIME_ASSERT_MSG(count > 0, "Failed to read input stream");
+        buffer.append(chunk.data(), count);
+      }
+      bytes = buffer.data();
+      length = buffer.size();
+    }
+#endif
+
+  public:
+    explicit MappedInput(const std::string_view path) {
+#ifdef AOC_HAS_MMAP
+      if (path == "-") {
+        readAll(STDIN_FILENO);
+        return;
+      }
+
+      const std::string filename(path);
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      RUNTIME_ASSERT_MSG(fd >= 0, "Failed to open input file");
+
+      struct stat info;
+      if (0 == ::fstat(fd, &info) && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *addr = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+          ::madvise(addr, info.st_size, MADV_SEQUENTIAL);
+          bytes = static_cast<const char*>(addr);
+          length = info.st_size;
+          mapped = true;
+        }
+      }
+      if (!mapped) {
+        readAll(fd); // Pipes, character devices, procfs files, etc.
+      }
+      ::close(fd);
+#else
+      std::ifstream ifs;
+      if (path != "-") {
+        ifs.open(std::string(path), std::ios::binary);
+        RUNTIME_ASSERT_MSG(ifs.is_open(), "Failed to open input file");
+      }
+      std::istream &is = (path == "-" ? std::cin : ifs);
+      buffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+      bytes = buffer.data();
+      length = buffer.size();
+#endif
+    }
+
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+
+    ~MappedInput() {
+#ifdef AOC_HAS_MMAP
+      if (mapped) {
+        ::munmap(const_cast<char*>(bytes), length);
+      }
+#endif
+    }
+
+    std::string_view view() const {
+      return std::string_view(bytes, length);
+    }
+
+    LineIndex index() const {
+      return LineIndex(view());
+    }
+
+    // All non-blank lines (see LineIndex). Views point into the mapping.
+    std::vector<std::string_view> lines() const {
+      const LineIndex idx = index();
+      std::vector<std::string_view> result;
+      result.reserve(idx.size());
+      for (std::size_t i = 0; i < idx.size(); ++i) {
+        result.push_back(idx[i]);
+      }
+      return result;
+    }
+
+    // Whole input with all whitespace removed. Leading/trailing whitespace is trimmed in
+    // place, so this is zero-copy unless whitespace shows up in the middle of the input.
+    std::span<const char> singleLine() const {
+      const char *first = bytes;
+      const char *last = bytes + length;
+      while (first < last && isWhitespace(*first)) {
+        ++first;
+      }
+      while (last > first && isWhitespace(*(last - 1))) {
+        --last;
+      }
+      if (std::none_of(first, last, isWhitespace)) {
+        return std::span<const char>(first, last);
+      }
+      compacted.clear();
+      std::copy_if(first, last, std::back_inserter(compacted), [](const char ch) { return !isWhitespace(ch); });
+      return std::span<const char>(compacted.data(), compacted.size());
+    }
+  };
+
   template <typename T>
   requires std::is_same_v<T, char> || std::is_same_v<T, std::string>
   class ReadFileStream {
@@ -141,25 +449,14 @@ namespace aoc {
   template <typename T>
   requires std::is_same_v<T, char> || std::is_same_v<T, std::string>
   std::vector<T> getLineInput(const std::string_view filename) {
-    reloadStdinStream(filename);
-    std::vector<T> input;
+    const MappedInput file(filename);
     if constexpr (std::is_same_v<T, char>) {
-      char ch;
-      while (std::cin.get(ch)) {
-        if (!aoc::containsChar(ch, {' ', '\n', '\r', '\t'})) {
-          input.push_back(ch);
-        }
-      }
+      const std::span<const char> line = file.singleLine();
+      return std::vector<T>(line.begin(), line.end());
     } else {
-      std::string line;
-      while (std::getline(std::cin, line)) {
-        if (!line.empty()) {
-          input.push_back(line);
-        }
-      }
+      const std::vector<std::string_view> lines = file.lines();
+      return std::vector<T>(lines.begin(), lines.end());
     }
-    closeStdinStream();
-    return input;
   }
 
   template <typename T>
@@ -175,42 +472,953 @@ namespace aoc {
     return ss.str();
   }
 
+  // Integer parsing
+  template <std::integral T>
+  struct ParseResult {
+    T value;
+    const char *end; // First character that wasn't consumed
+    std::errc ec;
+
+    explicit operator bool() const noexcept {
+      return ec == std::errc{};
+    }
+  };
+
+  // SIMD-within-a-register helpers for short decimal fields. Chunks are 8 bytes loaded
+  // little-endian, so the first character of the field sits in the lowest byte.
+  namespace swar {
+    // Number of leading ASCII digits in the chunk (0..8).
+    constexpr U32 digitRunLength(const U64 chunk) noexcept {
+      const U64 digits = chunk ^ 0x3030303030303030ULL; // '0'..'9' become 0x00..0x09
+      const U64 nondigit = (((digits & 0x7F7F7F7F7F7F7F7FULL) + 0x7676767676767676ULL) | digits) & 0x8080808080808080ULL;
+      return nondigit == 0 ? 8 : std::countr_zero(nondigit) / 8;
+    }
+
+    // Converts the first `count` (1..8) digits of the chunk to their value.
+    constexpr U64 parseDigits(const U64 chunk, const U32 count) noexcept {
+      U64 value = (chunk ^ 0x3030303030303030ULL) << (8 * (8 - count)); // Left-pad with zero digits
+      value = (value * 10 + (value >> 8)) & 0x00FF00FF00FF00FFULL;
+      value = (value * 100 + (value >> 16)) & 0x0000FFFF0000FFFFULL;
+      value = (value * 10000 + (value >> 32)) & 0x00000000FFFFFFFFULL;
+      return value;
+    }
+  }
+
+  // Exception-free integer parsing on top of std::from_chars. No leading whitespace or
+  // '+' is accepted. Decimal fields of up to 8 digits take a SWAR fast path when at
+  // least 8 bytes are readable from `first`.
+  template <std::integral T, int BASE = 10>
+  ParseResult<T> parse(const char *first, const char *last) noexcept {
+    if constexpr (BASE == 10 && std::endian::native == std::endian::little) {
+      if (last - first >= 8) {
+        U64 chunk;
+        std::memcpy(&chunk, first, sizeof(chunk));
+        const U32 count = swar::digitRunLength(chunk);
+        const bool complete = count < 8 || last - first == 8 || static_cast<U8>(first[8] - '0') > 9;
+        if (count > 0 && complete) {
+          const U64 value = swar::parseDigits(chunk, count);
+          if (value > static_cast<U64>(std::numeric_limits<T>::max())) {
+            return {T{}, first + count, std::errc::result_out_of_range};
+          }
+          return {static_cast<T>(value), first + count, std::errc{}};
+        }
+      }
+    }
+    T value{};
+    const std::from_chars_result result = std::from_chars(first, last, value, BASE);
+    return {value, result.ptr, result.ec};
+  }
+
+  template <std::integral T, int BASE = 10>
+  ParseResult<T> parse(const std::string_view str) noexcept {
+    return parse<T, BASE>(str.data(), str.data() + str.size());
+  }
+
+  // N integer fields joined by 'separator' (e.g. "2x3x4"). Returns std::nullopt if a field
+  // doesn't parse or the line ends before the next separator.
+  template <std::integral T, std::size_t N>
+  std::optional<std::array<T, N>> parseFields(const std::string_view line, const char separator) noexcept {
+    std::array<T, N> fields{};
+    const char *first = line.data();
+    const char *last = line.data() + line.size();
+    for (std::size_t i = 0; i < N; ++i) {
+      const ParseResult<T> field = parse<T>(first, last);
+      if (!field) {
+        return std::nullopt;
+      }
+      fields[i] = field.value;
+      if (i + 1 < N) {
+        if (field.end == last || *field.end != separator) {
+          return std::nullopt;
+        }
+        first = field.end + 1;
+      }
+    }
+    return fields;
+  }
+
   template <int N = 10>
-  std::optional<U64> to_u64(const std::string_view str) {
-    try {
-      return std::optional<U64>{ std::stoul(str.data(), nullptr, N) };
-    } catch (const std::invalid_argument &e) {
-      std::cerr << "Failed to convert " << quote(str) << " due to invalid_argument error: " << e.what() << std::endl;
-    } catch (const std::out_of_range &e) {
-      std::cerr << "Failed to convert " << quote(str) << " due to out_of_range error: " << e.what() << std::endl;
+  std::optional<U64> to_u64(std::string_view str) {
+    str.remove_prefix(std::min(str.find_first_not_of(" \t\n\r"), str.size()));
+    const ParseResult<U64> result = parse<U64, N>(str);
+    if (result.ec == std::errc::invalid_argument) {
+      std::cerr << "Failed to convert " << quote(str) << " due to invalid_argument error" << std::endl;
+    } else if (result.ec == std::errc::result_out_of_range) {
+      std::cerr << "Failed to convert " << quote(str) << " due to out_of_range error" << std::endl;
+    } else {
+      return std::optional<U64>{ result.value };
     }
     return std::nullopt;
   }
 
-  std::vector<char> getSingleLineInput(const std::string_view filename) {
-   reloadStdinStream(filename);
-   std::vector<char> input;
-   char ch;
-   while (std::cin.get(ch)) {
-     if (!containsChar(ch, {' ', '\n', '\r', '\t'})) {
-       input.push_back(ch);
-     }
-   }
-   closeStdinStream();
-   return input;
- }
-
-  std::vector<std::string> getMultiLineInput(const std::string_view filename) {
-    reloadStdinStream(filename);
-    std::vector<std::string> input;
-    std::string line;
-    while (std::getline(std::cin, line)) {
-      if (!line.empty()) {
-        input.push_back(line);
-      }
-    }
-    closeStdinStream();
-    return input;
+  inline std::vector<char> getSingleLineInput(const std::string_view filename) {
+    return getLineInput<char>(filename);
+  }
+
+  inline std::vector<std::string> getMultiLineInput(const std::string_view filename) {
+    return getLineInput<std::string>(filename);
+  }
+
+  // String interner handing out dense ids in first-seen order. Names of one or two lowercase
+  // letters (e.g. circuit wires) go through a perfect hash into a direct table; anything else
+  // falls back to open addressing.
+  class Interner {
+  public:
+    static constexpr U32 NONE = ~0U;
+    static constexpr std::size_t SHORT_SLOTS = 26 + 26 * 26;
+
+    Interner() { direct.fill(NONE); }
+
+    U32 intern(const std::string_view name) {
+      if (const std::optional<std::size_t> slot = shortSlot(name)) {
+        U32 &id = direct[*slot];
+        if (id == NONE) {
+          id = add(name);
+        }
+        return id;
+      }
+      if (2 * (spilled + 1) > overflow.size()) {
+        grow();
+      }
+      U32 &id = overflow[probe(name)];
+      if (id == NONE) {
+        id = add(name);
+        ++spilled;
+      }
+      return id;
+    }
+
+    std::optional<U32> find(const std::string_view name) const {
+      U32 id = NONE;
+      if (const std::optional<std::size_t> slot = shortSlot(name)) {
+        id = direct[*slot];
+      } else if (!overflow.empty()) {
+        id = overflow[probe(name)];
+      }
+      return id == NONE ? std::nullopt : std::optional<U32>{id};
+    }
+
+    std::string_view name(const U32 id) const { return names[id]; }
+    std::size_t size() const { return names.size(); }
+
+    // 'a'..'z' -> 0..25, 'aa'..'zz' -> 26..701
+    static constexpr std::optional<std::size_t> shortSlot(const std::string_view name) {
+      const auto isLower = [](const char ch) { return ch >= 'a' && ch <= 'z'; };
+      if (name.size() == 1 && isLower(name[0])) {
+        return name[0] - 'a';
+      }
+      if (name.size() == 2 && isLower(name[0]) && isLower(name[1])) {
+        return 26 + (name[0] - 'a') * 26 + (name[1] - 'a');
+      }
+      return std::nullopt;
+    }
+
+  private:
+    std::array<U32, SHORT_SLOTS> direct;
+    std::vector<U32> overflow; // Power-of-two capacity, at most half full
+    std::size_t spilled = 0;
+    std::vector<std::string> names;
+
+    // FNV-1a
+    static U64 hash(const std::string_view name) {
+      U64 value = 0xcbf29ce484222325ULL;
+      for (const char ch : name) {
+        value = (value ^ static_cast<U8>(ch)) * 0x100000001b3ULL;
+      }
+      return value;
+    }
+
+    std::size_t probe(const std::string_view name) const {
+      const std::size_t mask = overflow.size() - 1;
+      std::size_t i = hash(name) & mask;
+      while (overflow[i] != NONE && names[overflow[i]] != name) {
+        i = (i + 1) & mask;
+      }
+      return i;
+    }
+
+    void grow() {
+      std::vector<U32> old = std::exchange(overflow, std::vector<U32>(std::max<std::size_t>(16, 2 * overflow.size()), NONE));
+      for (const U32 id : old) {
+        if (id != NONE) {
+          overflow[probe(names[id])] = id;
+        }
+      }
+    }
+
+    U32 add(const std::string_view name) {
+      names.emplace_back(name);
+      return static_cast<U32>(names.size() - 1);
+    }
+  };
+
+  // Set of 2D integer coordinates. Each (x, y) is packed into one 64-bit key and stored
+  // in place with linear probing, so inserts never allocate per element.
+  class FlatCoordSet {
+  public:
+    explicit FlatCoordSet(const std::size_t expected = 0) {
+      slots.assign(std::bit_ceil(std::max<std::size_t>(16, 2 * expected)), EMPTY);
+    }
+
+    // Returns true if the coordinate wasn't in the set yet
+    bool insert(const I32 x, const I32 y) {
+      const U64 key = pack(x, y);
+      if (key == EMPTY) { // The marker's own coordinate is tracked on the side
+        if (has_marker) {
+          return false;
+        }
+        has_marker = true;
+        ++count;
+        return true;
+      }
+      if (2 * (count + 1) > slots.size()) {
+        grow();
+      }
+      U64 &slot = slots[probe(key)];
+      if (slot == key) {
+        return false;
+      }
+      slot = key;
+      ++count;
+      return true;
+    }
+
+    bool contains(const I32 x, const I32 y) const {
+      const U64 key = pack(x, y);
+      return key == EMPTY ? has_marker : slots[probe(key)] == key;
+    }
+
+    std::size_t size() const { return count; }
+    std::size_t memoryBytes() const { return slots.capacity() * sizeof(U64); }
+
+    // Calls func(x, y) for every coordinate, in no particular order
+    template <typename FUNC>
+    void forEach(FUNC &&func) const {
+      if (has_marker) {
+        func(INT32_MIN, INT32_MIN);
+      }
+      for (const U64 key : slots) {
+        if (key != EMPTY) {
+          func(static_cast<I32>(static_cast<U32>(key >> 32)), static_cast<I32>(static_cast<U32>(key)));
+        }
+      }
+    }
+
+  private:
+    static constexpr U64 EMPTY = 0x8000000080000000ULL; // (INT32_MIN, INT32_MIN)
+
+    std::vector<U64> slots; // Power-of-two capacity, at most half full
+    std::size_t count = 0;
+    bool has_marker = false;
+
+    static U64 pack(const I32 x, const I32 y) {
+      return (U64{static_cast<U32>(x)} << 32) | static_cast<U32>(y);
+    }
+
+    // MurmurHash3 finalizer: neighbouring coordinates land far apart
+    static U64 mix(U64 key) {
+      key ^= key >> 33;
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      key *= 0xc4ceb9fe1a85ec53ULL;
+      key ^= key >> 33;
+      return key;
+    }
+
+    std::size_t probe(const U64 key) const {
+      const std::size_t mask = slots.size() - 1;
+      std::size_t i = mix(key) & mask;
+      while (slots[i] != EMPTY && slots[i] != key) {
+        i = (i + 1) & mask;
+      }
+      return i;
+    }
+
+    void grow() {
+      const std::vector<U64> old = std::exchange(slots, std::vector<U64>(2 * slots.size(), EMPTY));
+      for (const U64 key : old) {
+        if (key != EMPTY) {
+          slots[probe(key)] = key;
+        }
+      }
+    }
+  };
+
+  // Worker threads. THREADS overrides the hardware count, e.g. `THREADS=4 make day6`
+  inline std::size_t threadCount() {
+    if (const char *threads = std::getenv("THREADS")) {
+      const ParseResult<std::size_t> count = parse<std::size_t>(std::string_view(threads));
+      if (count && count.value > 0) {
+        return count.value;
+      }
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  // Runs func(worker) for every worker in [0, workers) on its own thread and waits for
+  // all of them. Worker 0 runs on the calling thread.
+  template <typename FUNC>
+  void runWorkers(const std::size_t workers, FUNC &&func) {
+    std::vector<std::jthread> threads;
+    threads.reserve(workers > 0 ? workers - 1 : 0);
+    for (std::size_t worker = 1; worker < workers; ++worker) {
+      threads.emplace_back([&func, worker]() { func(worker); });
+    }
+    if (workers > 0) {
+      func(std::size_t{0});
+    }
+  }
+
+  // Lowers 'target' to 'value' unless it already holds something smaller (std::atomic::fetch_min
+  // is C++26). Returns the previous value.
+  template <std::unsigned_integral T>
+  T fetchMin(std::atomic<T> &target, const T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+    }
+    return current;
+  }
+
+  // Which digests a hash search accepts: the leading bytes must equal 'target' under 'mask'.
+  class HashPredicate {
+  private:
+    std::array<UCHAR, 32> mask{};
+    std::array<UCHAR, 32> target{};
+
+  public:
+    // The first 'bits' bits (most significant first) are zero
+    static HashPredicate leadingZeroBits(const U32 bits) {
+      RUNTIME_ASSERT_MSG(bits <= 8 * 32, "HashPredicate covers at most 32 digest bytes");
+      HashPredicate predicate;
+      for (U32 i = 0; i < bits; ++i) {
+        predicate.mask[i / 8] |= static_cast<UCHAR>(0x80 >> (i % 8));
+      }
+      return predicate;
+    }
+
+    // The hex digest starts with 'nibbles' zeros
+    static HashPredicate leadingZeroNibbles(const U32 nibbles) {
+      return leadingZeroBits(4 * nibbles);
+    }
+
+    // The leading digest bytes equal 'target' wherever 'mask' is set
+    static HashPredicate prefixMask(const std::span<const UCHAR> target, const std::span<const UCHAR> mask) {
+      RUNTIME_ASSERT_MSG(target.size() == mask.size() && mask.size() <= 32, "HashPredicate needs a target byte per mask byte");
+      HashPredicate predicate;
+      for (std::size_t i = 0; i < mask.size(); ++i) {
+        predicate.mask[i] = mask[i];
+        predicate.target[i] = target[i] & mask[i];
+      }
+      return predicate;
+    }
+
+    // Number of leading digest bytes the predicate looks at
+    std::size_t length() const {
+      std::size_t length = mask.size();
+      while (length > 0 && mask[length - 1] == 0) {
+        --length;
+      }
+      return length;
+    }
+
+    bool operator()(const std::span<const UCHAR> digest) const {
+      if (digest.size() < length()) {
+        return false;
+      }
+      for (std::size_t i = 0; i < length(); ++i) {
+        if ((digest[i] & mask[i]) != target[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Mask and target of digest bytes [4 * word, 4 * word + 4) as little-endian words, the way
+    // MD5 stores its state. A lane kernel can test `(word & mask) == target` directly.
+    U32 wordMask(const std::size_t word) const {
+      return U32{mask[4 * word]} | U32{mask[4 * word + 1]} << 8 | U32{mask[4 * word + 2]} << 16 | U32{mask[4 * word + 3]} << 24;
+    }
+
+    U32 wordTarget(const std::size_t word) const {
+      return U32{target[4 * word]} | U32{target[4 * word + 1]} << 8 | U32{target[4 * word + 2]} << 16 | U32{target[4 * word + 3]} << 24;
+    }
+  };
+
+  // Finds the lowest nonce in [start, end) whose hash satisfies a predicate. Hashing is left to
+  // a scanner, so any hash function and kernel can plug in. Workers claim chunks in increasing
+  // order and stop once every chunk below the best match is done, so the answer is the same as
+  // a sequential scan. With a checkpoint file, the scanned frontier is saved as the search goes
+  // and a restarted search with the same id picks up from there.
+  class HashSearch {
+  public:
+    struct Config {
+      U64 start = 0;
+      U64 end = UINT64_MAX; // Exclusive
+      U64 chunk = 1 << 16;
+      std::size_t workers = threadCount();
+      std::string checkpoint; // No checkpoint file if empty
+      std::string id;         // Identifies the search in the checkpoint (e.g. key and difficulty)
+      F64 report_seconds = 0; // Progress and checkpoint interval, 0 for only at the end
+      std::ostream *progress = nullptr; // Progress lines, none if null
+    };
+
+    struct WorkerStats {
+      U64 hashes = 0;
+      F64 seconds = 0;
+    };
+
+    // Lowest nonce in [first, last) that satisfies the predicate
+    using Scanner = std::function<std::optional<U64>(const HashPredicate &predicate, const U64 first, const U64 last)>;
+
+  private:
+    HashPredicate predicate;
+    Config config;
+    std::vector<WorkerStats> stats;
+
+    struct Checkpoint {
+      U64 frontier;             // Nothing in [start, frontier) matched, apart from 'found'
+      std::optional<U64> found;
+    };
+
+    std::optional<Checkpoint> load() const {
+      std::ifstream ifs(config.checkpoint);
+      std::string id, frontier, found;
+      if (!std::getline(ifs, id) || !std::getline(ifs, frontier) || !std::getline(ifs, found) || id != config.id) {
+        return std::nullopt; // Missing, unreadable, or written by another search
+      }
+      const ParseResult<U64> parsed_frontier = parse<U64>(frontier);
+      if (!parsed_frontier) {
+        return std::nullopt;
+      }
+      if (found.empty()) {
+        return Checkpoint{parsed_frontier.value, std::nullopt};
+      }
+      const ParseResult<U64> parsed_found = parse<U64>(found);
+      return parsed_found ? std::optional<Checkpoint>({parsed_frontier.value, parsed_found.value}) : std::nullopt;
+    }
+
+    // Written next to the file and renamed over it, so a crash never leaves half a checkpoint
+    void save(const Checkpoint &checkpoint) const {
+      const std::string temporary = config.checkpoint + ".tmp";
+      {
+        std::ofstream ofs(temporary, std::ios::trunc);
+        RUNTIME_ASSERT_MSG(ofs.is_open(), "Failed to open hash search checkpoint");
+        ofs << config.id << '\n' << checkpoint.frontier << '\n';
+        if (checkpoint.found) {
+          ofs << *checkpoint.found;
+        }
+        ofs << '\n';
+        RUNTIME_ASSERT_MSG(ofs.good(), "Failed to write hash search checkpoint");
+      }
+      RUNTIME_ASSERT_MSG(0 == std::rename(temporary.c_str(), config.checkpoint.c_str()), "Failed to replace hash search checkpoint");
+    }
+
+  public:
+    HashSearch(const HashPredicate &pred, const Config &conf) : predicate(pred), config(conf) {
+      RUNTIME_ASSERT_MSG(config.chunk > 0 && config.workers > 0, "HashSearch needs a chunk size and a worker");
+    }
+
+    // Lowest matching nonce, or nullopt if none is below 'end'
+    std::optional<U64> run(const Scanner &scanner) {
+      using Clock = std::chrono::steady_clock;
+      U64 start = config.start;
+      if (!config.checkpoint.empty()) {
+        if (const std::optional<Checkpoint> checkpoint = load()) {
+          if (checkpoint->found && *checkpoint->found >= config.start && *checkpoint->found < config.end) {
+            return checkpoint->found;
+          }
+          start = std::max(start, checkpoint->frontier);
+        }
+      }
+      if (start >= config.end) {
+        return std::nullopt;
+      }
+      const U64 chunks = (config.end - start - 1) / config.chunk + 1;
+
+      std::atomic<U64> next_chunk{0};
+      std::atomic<U64> best{UINT64_MAX};
+      std::atomic<U64> hashes{0};
+
+      // Chunks finish out of order; the frontier only moves over a contiguous run of them
+      std::mutex mutex;
+      std::set<U64> finished;
+      U64 unfinished = 0; // Lowest chunk not known to be done
+      const auto began = Clock::now();
+      auto reported = began;
+      const auto frontier = [&]() { return std::min({start + unfinished * config.chunk, best.load(), config.end}); };
+      const auto print = [&]() {
+        if (config.progress != nullptr) {
+          const F64 seconds = std::chrono::duration<F64>(Clock::now() - began).count();
+          *config.progress << "[HashSearch] " << config.id << ": scanned " << hashes.load() << " nonces, frontier "
+                           << frontier() << ", " << hashes.load() / std::max(seconds, 1e-9) / 1e6 << " MH/s" << std::endl;
+        }
+      };
+
+      stats.assign(config.workers, {});
+      runWorkers(config.workers, [&](const std::size_t worker) {
+        const auto worker_start = Clock::now();
+        for (;;) {
+          const U64 chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+          if (chunk >= chunks) {
+            break;
+          }
+          const U64 first = start + chunk * config.chunk;
+          const U64 last = std::min({first + std::min(config.chunk, config.end - first), best.load(std::memory_order_acquire)});
+          if (first >= last) {
+            break; // Every chunk below the best match is owned by some worker
+          }
+          const std::optional<U64> found = scanner(predicate, first, last);
+          const U64 scanned = (found ? *found + 1 : last) - first;
+          stats[worker].hashes += scanned;
+          hashes += scanned;
+          if (found) {
+            fetchMin(best, *found);
+          }
+
+          const std::lock_guard lock(mutex);
+          finished.insert(chunk);
+          while (!finished.empty() && *finished.begin() == unfinished) {
+            finished.erase(finished.begin());
+            ++unfinished;
+          }
+          if (config.report_seconds > 0 && std::chrono::duration<F64>(Clock::now() - reported).count() >= config.report_seconds) {
+            reported = Clock::now();
+            print();
+            if (!config.checkpoint.empty()) {
+              save({frontier(), std::nullopt});
+            }
+          }
+          if (found) {
+            break; // Every later chunk this worker could claim starts above this match
+          }
+        }
+        stats[worker].seconds = std::chrono::duration<F64>(Clock::now() - worker_start).count();
+      });
+
+      const std::optional<U64> result = best.load() < config.end ? std::optional<U64>(best.load()) : std::nullopt;
+      print();
+      if (!config.checkpoint.empty()) {
+        save({result ? *result : config.end, result});
+      }
+      return result;
+    }
+
+    // Hashes and running time of every worker in the last run
+    const std::vector<WorkerStats> &workerStats() const {
+      return stats;
+    }
+  };
+
+  // Solution registry. Every day registers its parts at static-init time, so a single
+  // driver binary can run any subset of days in one process and load each input once.
+  using Answer = I64;
+  using Solver = Answer (*)(const MappedInput &input); // nullptr if the part isn't solved yet
+
+  struct Solution {
+    std::string_view name;
+    std::string_view input;
+    Solver part1;
+    Solver part2;
+  };
+
+  inline std::vector<Solution> &registry() {
+    static std::vector<Solution> solutions; // Function-local to dodge static init order issues
+    return solutions;
+  }
+
+  struct Registrar {
+    explicit Registrar(const Solution solution) {
+      registry().push_back(solution);
+    }
+  };
+
+  // Registered solutions in day order ("day2" before "day10").
+  inline std::vector<Solution> sortedRegistry() {
+    std::vector<Solution> solutions = registry();
+    std::sort(solutions.begin(), solutions.end(), [](const Solution &lhs, const Solution &rhs) {
+      return lhs.name.size() != rhs.name.size() ? lhs.name.size() < rhs.name.size() : lhs.name < rhs.name;
+    });
+    return solutions;
+  }
+
+  // Runs the named solutions (all of them if `names` is empty) and reports per-part wall time.
+  // Returns the number of parts that failed.
+  inline int runSolutions(const std::vector<std::string_view> &names) {
+    using Clock = std::chrono::high_resolution_clock;
+    const std::vector<Solution> solutions = sortedRegistry();
+
+    int failures = 0;
+    for (const std::string_view name : names) {
+      const auto matches = [name](const Solution &solution) { return solution.name == name; };
+      if (std::none_of(solutions.cbegin(), solutions.cend(), matches)) {
+        std::cerr << "No solution registered for " << quote(name) << std::endl;
+        ++failures;
+      }
+    }
+
+    for (const Solution &solution : solutions) {
+      if (!names.empty() && std::find(names.cbegin(), names.cend(), solution.name) == names.cend()) {
+        continue;
+      }
+      const auto load_start = Clock::now();
+      const MappedInput input(solution.input);
+      const std::chrono::duration<F64, std::milli> load_time = Clock::now() - load_start;
+      std::cout << solution.name << "\tinput\t" << solution.input << "\t(" << load_time.count() << " ms)" << std::endl;
+
+      const std::array<Solver, 2> parts = {solution.part1, solution.part2};
+      for (std::size_t i = 0; i < parts.size(); ++i) {
+        const std::string row = std::string(solution.name) + "\tpart" + std::to_string(i + 1) + '\t';
+        if (parts[i] == nullptr) {
+          std::cout << row << "(not implemented)" << std::endl;
+          continue;
+        }
+        // Anything a solver prints goes to stderr, so it can't end up in the answer column
+        std::streambuf *const out = std::cout.rdbuf(std::cerr.rdbuf());
+        try {
+          const auto start = Clock::now();
+          const Answer answer = parts[i](input);
+          const std::chrono::duration<F64, std::milli> elapsed = Clock::now() - start;
+          std::cout.rdbuf(out);
+          std::cout << row << answer << "\t(" << elapsed.count() << " ms)" << std::endl;
+        } catch (const std::exception &e) {
+          std::cout.rdbuf(out);
+          std::cout << row << "FAILED: " << e.what() << std::endl;
+          ++failures;
+        }
+      }
+    }
+    return failures;
+  }
+
+  // Hardware performance counters around a region. Counters the kernel refuses to open
+  // (no PMU under a hypervisor, perf_event_paranoid, seccomp, non-Linux builds) read back
+  // as unavailable instead of failing, so the same instrumented code runs everywhere.
+  // Threads started inside the scope (e.g. by runWorkers) are counted once they have exited;
+  // threads that were already running before it are not.
+  class PerfScope {
+  public:
+    enum Counter : U8 { CYCLES, INSTRUCTIONS, BRANCH_MISSES, L1D_MISSES, LLC_MISSES, DTLB_MISSES, COUNTER_COUNT };
+
+    struct Report {
+      std::array<std::optional<U64>, COUNTER_COUNT> values;
+
+      std::optional<F64> ipc() const {
+        if (!values[CYCLES] || !values[INSTRUCTIONS] || values[CYCLES].value() == 0) {
+          return std::nullopt;
+        }
+        return static_cast<F64>(values[INSTRUCTIONS].value()) / values[CYCLES].value();
+      }
+
+      // Misses per thousand instructions
+      std::optional<F64> mpki(const Counter counter) const {
+        if (!values[counter] || !values[INSTRUCTIONS] || values[INSTRUCTIONS].value() == 0) {
+          return std::nullopt;
+        }
+        return 1000.0 * values[counter].value() / values[INSTRUCTIONS].value();
+      }
+
+      friend std::ostream &operator<<(std::ostream &os, const Report &report) {
+        const auto print = [&os](const std::string_view name, const std::optional<F64> value) {
+          os << name << '=';
+          value.has_value() ? (os << value.value()) : (os << "n/a");
+        };
+        print("IPC", report.ipc());
+        print(" branch-MPKI", report.mpki(BRANCH_MISSES));
+        print(" L1D-MPKI", report.mpki(L1D_MISSES));
+        print(" LLC-MPKI", report.mpki(LLC_MISSES));
+        print(" dTLB-MPKI", report.mpki(DTLB_MISSES));
+        return os;
+      }
+    };
+
+  private:
+    std::array<int, COUNTER_COUNT> fds;
+    std::ostream *os = nullptr;
+    std::string_view label;
+    std::optional<Report> result;
+
+#ifdef AOC_HAS_PERF_EVENTS
+    static constexpr U64 cacheMiss(const U64 cache) {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    static int open(const U32 type, const U64 config) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.config = config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.inherit = 1; // Also count child threads. The kernel rejects this with PERF_FORMAT_GROUP, so counters are read one by one
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+  public:
+    PerfScope() {
+      fds.fill(-1);
+#ifdef AOC_HAS_PERF_EVENTS
+      fds[CYCLES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+      fds[INSTRUCTIONS] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+      fds[BRANCH_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+      fds[L1D_MISSES] = open(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D));
+      fds[LLC_MISSES] = open(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL));
+      fds[DTLB_MISSES] = open(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB));
+      for (const int fd : fds) {
+        if (fd >= 0) {
+          ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+          ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+      }
+#endif
+    }
+
+    // Prints "<label>: <report>" to `out` when the scope ends.
+    PerfScope(std::ostream &out, const std::string_view name) : PerfScope() {
+      os = &out;
+      label = name;
+    }
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    ~PerfScope() {
+      const Report report = stop();
+      if (os != nullptr) {
+        *os << label << ": " << report << std::endl;
+      }
+    }
+
+    // Stops counting (first call only) and returns the counts, scaled up if the kernel had
+    // to multiplex counters.
+    Report stop() {
+      if (result.has_value()) {
+        return result.value();
+      }
+      Report report;
+#ifdef AOC_HAS_PERF_EVENTS
+      for (U8 i = 0; i < COUNTER_COUNT; ++i) {
+        if (fds[i] < 0) {
+          continue;
+        }
+        ::ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        std::array<U64, 3> data{}; // value, time enabled, time running
+        if (::read(fds[i], data.data(), sizeof(data)) == sizeof(data) && data[2] > 0) {
+          report.values[i] = static_cast<U64>(static_cast<F64>(data[0]) * data[1] / data[2]);
+        }
+        ::close(fds[i]);
+        fds[i] = -1;
+      }
+#endif
+      result = report;
+      return report;
+    }
+  };
+
+  // Micro-benchmarking of solution variants. Registered solution parts are always
+  // included; days register extra variants (alternative implementations of a part) here.
+  namespace bench {
+    // Keeps the compiler from discarding a result it can prove is unused.
+    template <typename T>
+    inline void DoNotOptimize(const T &value) {
+      asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    struct Config {
+      U32 warmup = 3;
+      U32 min_runs = 10;
+      U32 max_runs = 10000;
+      F64 target_rse = 0.01; // Stop once the relative standard error of the mean is below 1%
+      F64 max_seconds = 2.0; // Per-variant time budget, checked between runs
+    };
+
+    struct Stats {
+      U64 runs = 0;
+      F64 min = 0;    // All times are in milliseconds
+      F64 median = 0;
+      F64 p99 = 0;
+      F64 mean = 0;
+      F64 rse = 0;
+    };
+
+    // Times func() until the mean is stable (or the budget runs out) and summarizes the samples.
+    // If 'counters' is given, hardware counters are collected over the timed runs only.
+    template <typename FUNC>
+    Stats measure(FUNC &&func, const Config &config = {}, PerfScope::Report *counters = nullptr) {
+      using Clock = std::chrono::high_resolution_clock;
+      for (U32 i = 0; i < config.warmup; ++i) {
+        const auto start = Clock::now();
+        DoNotOptimize(func());
+        if (std::chrono::duration<F64>(Clock::now() - start).count() > config.max_seconds) {
+          break; // Too slow to bother warming up further
+        }
+      }
+
+      // Counters cover the timed runs only, not the warmup
+      std::optional<PerfScope> perf;
+      if (counters != nullptr) {
+        perf.emplace();
+      }
+      std::vector<F64> samples;
+      F64 total = 0, sum = 0, sum_squares = 0, rse = 0;
+      while (samples.size() < config.max_runs) {
+        const auto start = Clock::now();
+        DoNotOptimize(func());
+        const F64 elapsed = std::chrono::duration<F64, std::milli>(Clock::now() - start).count();
+        samples.push_back(elapsed);
+
+        total += elapsed / 1000.0;
+        sum += elapsed;
+        sum_squares += elapsed * elapsed;
+        const F64 n = static_cast<F64>(samples.size());
+        const F64 mean = sum / n;
+        const F64 variance = n > 1 ? std::max(0.0, (sum_squares - n * mean * mean) / (n - 1)) : 0.0;
+        rse = mean > 0 ? std::sqrt(variance / n) / mean : 0.0;
+        if ((samples.size() >= config.min_runs && rse <= config.target_rse) || total >= config.max_seconds) {
+          break;
+        }
+      }
+      if (perf.has_value()) {
+        *counters = perf->stop();
+      }
+
+      std::sort(samples.begin(), samples.end());
+      const auto rank = [&samples](const F64 percentile) {
+        const std::size_t index = static_cast<std::size_t>(std::ceil(percentile * samples.size()));
+        return samples[std::clamp<std::size_t>(index, 1, samples.size()) - 1];
+      };
+      return Stats{samples.size(), samples.front(), rank(0.5), rank(0.99), sum / samples.size(), rse};
+    }
+
+    struct Variant {
+      std::string_view day;   // Must match the name of a registered aoc::Solution (for its input)
+      std::string_view name;
+      Solver solver;
+    };
+
+    inline std::vector<Variant> &registry() {
+      static std::vector<Variant> variants;
+      return variants;
+    }
+
+    struct Registrar {
+      Registrar(const std::initializer_list<Variant> variants) {
+        registry().insert(registry().end(), variants.begin(), variants.end());
+      }
+    };
+
+    struct Result {
+      Variant variant;
+      Answer answer;
+      Stats stats;
+      PerfScope::Report counters; // Accumulated over every measured run, warmup excluded
+    };
+
+    // Writes results as JSON if the path ends in ".json", otherwise as CSV. Unavailable
+    // counter ratios are written as null (JSON) or left empty (CSV).
+    inline void writeResults(const std::string_view path, const std::vector<Result> &results) {
+      std::ofstream ofs{std::string(path)};
+      RUNTIME_ASSERT_MSG(ofs.is_open(), "Failed to open benchmark output file");
+      const bool json = path.ends_with(".json");
+      const auto ratio = [&ofs, json](const std::optional<F64> value) -> std::ostream& {
+        return value.has_value() ? (ofs << value.value()) : (ofs << (json ? "null" : ""));
+      };
+      if (json) {
+        ofs << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+          const Result &r = results[i];
+          ofs << "  {\"day\": " << quote(r.variant.day) << ", \"variant\": " << quote(r.variant.name)
+              << ", \"answer\": " << r.answer << ", \"runs\": " << r.stats.runs
+              << ", \"min_ms\": " << r.stats.min << ", \"median_ms\": " << r.stats.median
+              << ", \"p99_ms\": " << r.stats.p99 << ", \"mean_ms\": " << r.stats.mean
+              << ", \"rse\": " << r.stats.rse << ", \"ipc\": ";
+          ratio(r.counters.ipc()) << ", \"branch_mpki\": ";
+          ratio(r.counters.mpki(PerfScope::BRANCH_MISSES)) << ", \"l1d_mpki\": ";
+          ratio(r.counters.mpki(PerfScope::L1D_MISSES)) << ", \"llc_mpki\": ";
+          ratio(r.counters.mpki(PerfScope::LLC_MISSES)) << ", \"dtlb_mpki\": ";
+          ratio(r.counters.mpki(PerfScope::DTLB_MISSES)) << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        ofs << "]\n";
+      } else {
+        ofs << "day,variant,answer,runs,min_ms,median_ms,p99_ms,mean_ms,rse,ipc,branch_mpki,l1d_mpki,llc_mpki,dtlb_mpki\n";
+        for (const Result &r : results) {
+          ofs << r.variant.day << ',' << r.variant.name << ',' << r.answer << ',' << r.stats.runs << ','
+              << r.stats.min << ',' << r.stats.median << ',' << r.stats.p99 << ',' << r.stats.mean << ','
+              << r.stats.rse << ',';
+          ratio(r.counters.ipc()) << ',';
+          ratio(r.counters.mpki(PerfScope::BRANCH_MISSES)) << ',';
+          ratio(r.counters.mpki(PerfScope::L1D_MISSES)) << ',';
+          ratio(r.counters.mpki(PerfScope::LLC_MISSES)) << ',';
+          ratio(r.counters.mpki(PerfScope::DTLB_MISSES)) << '\n';
+        }
+      }
+    }
+
+    // Benchmarks every solution part and registered variant of the named days (all if empty),
+    // printing a table and writing machine-readable results to `output`.
+    inline int runAll(const std::vector<std::string_view> &names, const std::string_view output, const Config &config = {}) {
+      const auto selected = [&names](const std::string_view day) {
+        return names.empty() || std::find(names.cbegin(), names.cend(), day) != names.cend();
+      };
+
+      const std::vector<Solution> solutions = sortedRegistry();
+
+      std::vector<Result> results;
+      for (const Solution &solution : solutions) {
+        if (!selected(solution.name)) {
+          continue;
+        }
+        std::vector<Variant> variants;
+        if (solution.part1 != nullptr) {
+          variants.push_back({solution.name, "part1", solution.part1});
+        }
+        if (solution.part2 != nullptr) {
+          variants.push_back({solution.name, "part2", solution.part2});
+        }
+        for (const Variant &variant : bench::registry()) {
+          if (variant.day == solution.name) {
+            variants.push_back(variant);
+          }
+        }
+
+        const MappedInput input(solution.input);
+        for (const Variant &variant : variants) {
+          const Answer answer = variant.solver(input);
+          PerfScope::Report counters;
+          const Stats stats = measure([&]() { return variant.solver(input); }, config, &counters);
+          results.push_back({variant, answer, stats, counters});
+          std::cout << variant.day << '\t' << variant.name << "\tanswer=" << answer << "\truns=" << stats.runs
+                    << "\tmin=" << stats.min << " ms\tmedian=" << stats.median << " ms\tp99=" << stats.p99
+                    << " ms\trse=" << stats.rse * 100 << "%\t" << counters << std::endl;
+        }
+      }
+
+      writeResults(output, results);
+      std::cout << "Wrote " << results.size() << " benchmark results to " << quote(output) << std::endl;
+      return 0;
+    }
   }
 
 }
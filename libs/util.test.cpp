@@ -1,3 +1,5 @@
+#include <numeric>
+
 #include "util.hpp"
 
 static void test_func(const std::string_view str) {
@@ -25,8 +27,124 @@ int main() {
   RUNTIME_ASSERT(lines[3] == "	There is a tab here");
   RUNTIME_ASSERT(lines[4] == "        ");
 
+  const aoc::MappedInput file("input/util.dat");
+  const std::vector<std::string_view> views = file.lines();
+  RUNTIME_ASSERT(views.size() == lines.size());
+  RUNTIME_ASSERT(std::equal(views.cbegin(), views.cend(), lines.cbegin()));
+  const std::span<const char> chars = file.singleLine();
+  RUNTIME_ASSERT(std::string_view(chars.data(), chars.size()) == lineStr);
+  RUNTIME_ASSERT(file.view().size() == 49);
+
+  const std::string crlf = "first\r\n\r\n\n  second line that is long enough to cross a 32-byte block\r\nthird\r";
+  const aoc::LineIndex index(crlf);
+  RUNTIME_ASSERT(index.size() == 3);
+  RUNTIME_ASSERT(index[0] == "first");
+  RUNTIME_ASSERT(index[1] == "  second line that is long enough to cross a 32-byte block");
+  RUNTIME_ASSERT(index[2] == "third");
+
   RUNTIME_ASSERT_MSG(42uL == aoc::to_u64("42"), "42 == 42");
 
+  const std::string_view fields = "1234x567890123x9\n";
+  const aoc::ParseResult<U32> f1 = aoc::parse<U32>(fields);
+  RUNTIME_ASSERT(f1 && f1.value == 1234 && *f1.end == 'x');
+  const aoc::ParseResult<U64> f2 = aoc::parse<U64>(f1.end + 1, fields.data() + fields.size());
+  RUNTIME_ASSERT(f2 && f2.value == 567890123 && *f2.end == 'x');
+  const aoc::ParseResult<U16> f3 = aoc::parse<U16>(f2.end + 1, fields.data() + fields.size());
+  RUNTIME_ASSERT(f3 && f3.value == 9 && *f3.end == '\n');
+  RUNTIME_ASSERT(aoc::parse<U16>("65536 -> a").ec == std::errc::result_out_of_range);
+  RUNTIME_ASSERT(aoc::parse<U16>("x AND y").ec == std::errc::invalid_argument);
+  RUNTIME_ASSERT(aoc::parse<I32>("-42").value == -42);
+  RUNTIME_ASSERT((aoc::parse<U32, 16>("ff").value == 255));
+  RUNTIME_ASSERT((aoc::parseFields<U64, 3>("2x3x4", 'x') == std::array<U64, 3>{2, 3, 4}));
+  RUNTIME_ASSERT(!(aoc::parseFields<U64, 3>("2x3", 'x')));
+  RUNTIME_ASSERT(!(aoc::parseFields<U64, 3>("2x3x", 'x')));
+  RUNTIME_ASSERT(!(aoc::parseFields<U64, 3>("", 'x')));
+
+  const aoc::bench::Stats stats = aoc::bench::measure([]() { return aoc::parse<U64>("123456789").value; });
+  RUNTIME_ASSERT(stats.runs >= 1);
+  RUNTIME_ASSERT(stats.min <= stats.median && stats.median <= stats.p99);
+  // Two warmup runs, then one timed run inside the counter scope
+  aoc::PerfScope::Report report;
+  U32 calls = 0;
+  const aoc::bench::Stats counted = aoc::bench::measure([&calls]() { return ++calls; }, {.warmup = 2, .min_runs = 1, .max_runs = 1}, &report);
+  RUNTIME_ASSERT(counted.runs == 1 && calls == 3);
+
+  aoc::Interner interner;
+  const U32 a = interner.intern("a");
+  const U32 zz = interner.intern("zz");
+  const U32 literal = interner.intern("44430");
+  RUNTIME_ASSERT(a == 0 && zz == 1 && literal == 2);
+  RUNTIME_ASSERT(interner.intern("a") == a && interner.intern("44430") == literal);
+  RUNTIME_ASSERT(interner.find("zz") == zz && !interner.find("q") && !interner.find("longer"));
+  for (U32 i = 0; i < 100; ++i) { // Forces the overflow table to grow
+    RUNTIME_ASSERT(interner.intern("wire" + std::to_string(i)) == 3 + i);
+  }
+  RUNTIME_ASSERT(interner.find("wire42") == 45 && interner.name(45) == "wire42" && interner.size() == 103);
+
+  aoc::FlatCoordSet coords;
+  RUNTIME_ASSERT(coords.insert(0, 0) && !coords.insert(0, 0) && coords.insert(-1, 0) && coords.insert(0, -1));
+  RUNTIME_ASSERT(coords.insert(INT32_MIN, INT32_MIN) && !coords.insert(INT32_MIN, INT32_MIN) && coords.contains(INT32_MIN, INT32_MIN));
+  for (I32 i = 0; i < 1000; ++i) { // Forces growth
+    coords.insert(i, -i);
+  }
+  RUNTIME_ASSERT(coords.size() == 4 + 999 && coords.contains(999, -999) && !coords.contains(999, 999));
+  aoc::FlatCoordSet copy;
+  coords.forEach([&copy](const I32 x, const I32 y) { copy.insert(x, y); });
+  RUNTIME_ASSERT(copy.size() == coords.size() && copy.contains(-1, 0) && copy.contains(INT32_MIN, INT32_MIN));
+
+  std::vector<std::size_t> workers(4, 0);
+  aoc::runWorkers(workers.size(), [&workers](const std::size_t worker) { workers[worker] = worker + 1; });
+  RUNTIME_ASSERT(std::accumulate(workers.begin(), workers.end(), std::size_t{0}) == 10);
+  RUNTIME_ASSERT(aoc::threadCount() >= 1);
+  std::atomic<U64> lowest{100};
+  aoc::runWorkers(workers.size(), [&lowest](const std::size_t worker) { aoc::fetchMin(lowest, U64{40 + worker}); });
+  RUNTIME_ASSERT(lowest == 40 && aoc::fetchMin(lowest, U64{50}) == 40 && lowest == 40);
+
+  const aoc::HashPredicate five_zeros = aoc::HashPredicate::leadingZeroNibbles(5);
+  RUNTIME_ASSERT(five_zeros.length() == 3 && five_zeros.wordMask(0) == 0x00F0FFFF && five_zeros.wordTarget(0) == 0);
+  const std::array<UCHAR, 2> prefix = {0xAB, 0xC0}, prefix_mask = {0xFF, 0xF0};
+  const aoc::HashPredicate abc = aoc::HashPredicate::prefixMask(prefix, prefix_mask);
+  RUNTIME_ASSERT(abc(std::array<UCHAR, 3>{0xAB, 0xCD, 0xEF}) && !abc(std::array<UCHAR, 3>{0xAB, 0xDC, 0xEF}));
+
+  // Stand-in hash: the nonce times a large odd constant, most significant byte first
+  const auto toy_scanner = [](const aoc::HashPredicate &predicate, const U64 first, const U64 last) -> std::optional<U64> {
+    for (U64 nonce = first; nonce < last; ++nonce) {
+      const U64 hash = nonce * 0x9E3779B97F4A7C15ULL;
+      std::array<UCHAR, 8> digest;
+      for (std::size_t i = 0; i < digest.size(); ++i) {
+        digest[i] = static_cast<UCHAR>(hash >> (56 - 8 * i));
+      }
+      if (predicate(digest)) {
+        return nonce;
+      }
+    }
+    return std::nullopt;
+  };
+  const aoc::HashPredicate zero_bits = aoc::HashPredicate::leadingZeroBits(14);
+  const std::optional<U64> expected = toy_scanner(zero_bits, 1, UINT64_MAX);
+  aoc::HashSearch::Config search_config;
+  search_config.start = 1;
+  search_config.chunk = 64;
+  search_config.workers = 4;
+  RUNTIME_ASSERT(aoc::HashSearch(zero_bits, search_config).run(toy_scanner) == expected);
+
+  // An interrupted search resumes from its checkpoint without rescanning
+  search_config.checkpoint = "/tmp/aoc_util_test.checkpoint";
+  search_config.id = "toy 14 bits";
+  std::remove(search_config.checkpoint.c_str());
+  search_config.end = *expected - 10;
+  RUNTIME_ASSERT(!aoc::HashSearch(zero_bits, search_config).run(toy_scanner));
+  search_config.end = UINT64_MAX;
+  U64 lowest_scanned = UINT64_MAX;
+  std::mutex scanned_mutex;
+  const auto resumed = aoc::HashSearch(zero_bits, search_config).run([&](const aoc::HashPredicate &predicate, const U64 first, const U64 last) {
+    const std::lock_guard lock(scanned_mutex);
+    lowest_scanned = std::min(lowest_scanned, first);
+    return toy_scanner(predicate, first, last);
+  });
+  RUNTIME_ASSERT(resumed == expected && lowest_scanned == *expected - 10);
+  std::remove(search_config.checkpoint.c_str());
+
   const auto func = [](const std::string_view str) { std::cout << "[LAMBDA] " << str << std::endl; };
   Logger logger1;
   Logger<func> logger2;